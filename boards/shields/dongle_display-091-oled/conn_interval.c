@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "conn_interval.h"
+#include "split_conn.h"
+
+static enum conn_interval_mode current_mode = conn_interval_mode_slow;
+static struct conn_interval_link links[CONFIG_BT_MAX_CONN];
+
+static const struct bt_le_conn_param fast_param = BT_LE_CONN_PARAM_INIT(
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_FAST, CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_FAST,
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_FAST_LATENCY,
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_TIMEOUT);
+
+static const struct bt_le_conn_param slow_param = BT_LE_CONN_PARAM_INIT(
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_SLOW, CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_SLOW,
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_SLOW_LATENCY,
+    CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_TIMEOUT);
+
+static void request_param(struct bt_conn *conn, void *data) {
+    const struct bt_le_conn_param *param = data;
+    struct bt_conn_info info;
+
+    if (!is_split_conn(conn, &info)) {
+        return;
+    }
+
+    int err = bt_conn_le_param_update(conn, param);
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to request split connection interval %u (err %d)", param->interval_min,
+                err);
+    }
+}
+
+static const struct bt_le_conn_param *mode_param(enum conn_interval_mode mode) {
+    return mode == conn_interval_mode_fast ? &fast_param : &slow_param;
+}
+
+// Only called from the work items below, which all run on the system work queue, so mode changes
+// never race each other.
+static void set_mode(enum conn_interval_mode mode) {
+    if (mode == current_mode) {
+        return;
+    }
+
+    current_mode = mode;
+    bt_conn_foreach(BT_CONN_TYPE_LE, request_param, (void *)mode_param(mode));
+}
+
+static void relax_work_cb(struct k_work *work) { set_mode(conn_interval_mode_slow); }
+
+static K_WORK_DELAYABLE_DEFINE(relax_work, relax_work_cb);
+
+static void go_fast(void) {
+    k_work_cancel_delayable(&relax_work);
+    set_mode(conn_interval_mode_fast);
+}
+
+static void press_work_cb(struct k_work *work) {
+    go_fast();
+    k_work_schedule(&relax_work, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_IDLE_MS));
+}
+
+static K_WORK_DEFINE(press_work, press_work_cb);
+
+static void idle_work_cb(struct k_work *work) {
+    // a press queued ahead of this one may already have made the keyboard active again
+    if (zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE) {
+        return;
+    }
+
+    k_work_cancel_delayable(&relax_work);
+    set_mode(conn_interval_mode_slow);
+}
+
+static K_WORK_DEFINE(idle_work, idle_work_cb);
+
+// links that already use the parameters of the current mode return -EALREADY
+static void sync_work_cb(struct k_work *work) {
+    bt_conn_foreach(BT_CONN_TYPE_LE, request_param, (void *)mode_param(current_mode));
+}
+
+static K_WORK_DEFINE(sync_work, sync_work_cb);
+
+static int conn_interval_listener(const zmk_event_t *eh) {
+    // Every press switches to fast and restarts the idle time. The WPM would only follow after its
+    // sampling interval and keeps changing while it decays. The mode change and parameter update
+    // go through the system work queue, not the thread raising the event.
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev != NULL) {
+        if (pos_ev->state) {
+            k_work_submit(&press_work);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_activity_state_changed *activity_ev = as_zmk_activity_state_changed(eh);
+    // becoming active always comes with a press
+    if (activity_ev != NULL && activity_ev->state != ZMK_ACTIVITY_ACTIVE) {
+        k_work_submit(&idle_work);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_conn_interval, conn_interval_listener);
+ZMK_SUBSCRIPTION(dongle_conn_interval, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(dongle_conn_interval, zmk_activity_state_changed);
+
+static void conn_interval_connected(struct bt_conn *conn, uint8_t err) {
+    struct bt_conn_info info;
+
+    if (err || !is_split_conn(conn, &info)) {
+        return;
+    }
+
+    links[bt_conn_index(conn)] = (struct conn_interval_link){
+        .connected = true,
+        .interval = info.le.interval,
+        .latency = info.le.latency,
+    };
+
+    // a new link starts out on the interval the central connected with, so it is moved to the
+    // one of the current mode right away rather than at the next mode change
+    k_work_submit(&sync_work);
+}
+
+static void conn_interval_disconnected(struct bt_conn *conn, uint8_t reason) {
+    links[bt_conn_index(conn)].connected = false;
+}
+
+static void conn_interval_le_param_updated(struct bt_conn *conn, uint16_t interval,
+                                           uint16_t latency, uint16_t timeout) {
+    struct conn_interval_link *link = &links[bt_conn_index(conn)];
+
+    if (link->connected) {
+        link->interval = interval;
+        link->latency = latency;
+    }
+}
+
+BT_CONN_CB_DEFINE(conn_interval_conn_callbacks) = {
+    .connected = conn_interval_connected,
+    .disconnected = conn_interval_disconnected,
+    .le_param_updated = conn_interval_le_param_updated,
+};
+
+enum conn_interval_mode conn_interval_get_mode(void) { return current_mode; }
+
+int conn_interval_get_link(uint8_t index, struct conn_interval_link *link) {
+    if (index >= CONFIG_BT_MAX_CONN) {
+        return -EINVAL;
+    }
+
+    *link = links[index];
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ *
+ * Copyright (c) 2024 The ZMK Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+enum conn_interval_mode {
+    conn_interval_mode_fast,
+    conn_interval_mode_slow
+};
+
+struct conn_interval_link {
+    bool connected;
+    // last interval reported by the controller, in 1.25 ms units
+    uint16_t interval;
+    uint16_t latency;
+};
+
+enum conn_interval_mode conn_interval_get_mode(void);
+// index is the Bluetooth connection index, only split links are reported as connected
+int conn_interval_get_link(uint8_t index, struct conn_interval_link *link);
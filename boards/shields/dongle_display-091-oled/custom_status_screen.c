@@ -5,11 +5,46 @@
  */
 
 #include "custom_status_screen.h"
+#include "pages.h"
+#include "stats/bench.h"
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP)
+#include "display_sleep.h"
+#endif
 #include "widgets/battery_status.h"
 #include "widgets/modifiers.h"
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HID_RATE)
+#include "widgets/hid_rate.h"
+#elif IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+#include "widgets/clock.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH)
+#include "widgets/wpm_graph.h"
+#else
 #include "widgets/bongo_cat.h"
+#endif
 #include "widgets/layer_status.h"
 #include "widgets/output_status.h"
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_PAGE)
+#include "widgets/link_health.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_PAGE)
+#include "widgets/conn_interval.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SPLIT_JITTER_PAGE)
+#include "widgets/split_jitter.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DECISION_LATENCY_PAGE)
+#include "widgets/decision_latency.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_MATRIX_PAGE)
+#include "widgets/key_matrix.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_STATS_PAGE)
+#include "widgets/key_stats.h"
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TELEMETRY_PAGE)
+#include "widgets/telemetry.h"
+#endif
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -17,37 +52,143 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 static struct zmk_widget_output_status output_status_widget;
 static struct zmk_widget_layer_status layer_status_widget;
 static struct zmk_widget_peripheral_battery_status peripheral_battery_status_widget;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HID_RATE)
+static struct zmk_widget_hid_rate hid_rate_widget;
+#elif IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+static struct zmk_widget_clock clock_widget;
+#else
 static struct zmk_widget_modifiers modifiers_widget;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH)
+static struct zmk_widget_wpm_graph wpm_graph_widget;
+#else
 static struct zmk_widget_bongo_cat bongo_cat_widget;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_PAGE)
+static struct zmk_widget_link_health link_health_widget;
+static struct dongle_page link_health_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_PAGE)
+static struct zmk_widget_conn_interval conn_interval_widget;
+static struct dongle_page conn_interval_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SPLIT_JITTER_PAGE)
+static struct zmk_widget_split_jitter split_jitter_widget;
+static struct dongle_page split_jitter_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DECISION_LATENCY_PAGE)
+static struct zmk_widget_decision_latency decision_latency_widget;
+static struct dongle_page decision_latency_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_MATRIX_PAGE)
+static struct zmk_widget_key_matrix key_matrix_widget;
+static struct dongle_page key_matrix_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_STATS_PAGE)
+static struct zmk_widget_key_stats key_stats_widget;
+static struct dongle_page key_stats_page;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TELEMETRY_PAGE)
+static struct zmk_widget_telemetry telemetry_widget;
+static struct dongle_page telemetry_page;
+#endif
+
+static struct dongle_page main_page;
 
 lv_style_t global_style;
 
 lv_obj_t *zmk_display_status_screen() {
     lv_obj_t *screen;
+    lv_obj_t *main_obj;
 
     screen = lv_obj_create(NULL);
 
+#if DONGLE_BENCH_DISPLAY_HOOKS
+    dongle_bench_hook_display(lv_disp_get_default());
+#endif
+
     lv_style_init(&global_style);
     lv_style_set_text_font(&global_style, &lv_font_unscii_8);
     lv_style_set_text_letter_space(&global_style, 1);
     lv_style_set_text_line_space(&global_style, 1);
     lv_obj_add_style(screen, &global_style, LV_PART_MAIN);
+
+    main_obj = dongle_page_add(&main_page, screen, "main", NULL);
     
-    // zmk_widget_output_status_init(&output_status_widget, screen);
-    // lv_obj_align(zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
+    zmk_widget_output_status_init(&output_status_widget, main_obj);
+    lv_obj_align(zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
     
-    zmk_widget_bongo_cat_init(&bongo_cat_widget, screen);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH)
+    zmk_widget_wpm_graph_init(&wpm_graph_widget, main_obj);
+    lv_obj_align(zmk_widget_wpm_graph_obj(&wpm_graph_widget), LV_ALIGN_BOTTOM_RIGHT, 0, -7);
+#else
+    zmk_widget_bongo_cat_init(&bongo_cat_widget, main_obj);
     lv_obj_align(zmk_widget_bongo_cat_obj(&bongo_cat_widget), LV_ALIGN_BOTTOM_RIGHT, 0, -7);
+#endif
 
-    zmk_widget_modifiers_init(&modifiers_widget, screen);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_HID_RATE)
+    zmk_widget_hid_rate_init(&hid_rate_widget, main_obj);
+    lv_obj_align(zmk_widget_hid_rate_obj(&hid_rate_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
+#elif IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+    zmk_widget_clock_init(&clock_widget, main_obj);
+    lv_obj_align(zmk_widget_clock_obj(&clock_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
+#else
+    zmk_widget_modifiers_init(&modifiers_widget, main_obj);
     lv_obj_align(zmk_widget_modifiers_obj(&modifiers_widget), LV_ALIGN_BOTTOM_LEFT, 0, 0);
+#endif
     
-    zmk_widget_layer_status_init(&layer_status_widget, screen);
-    lv_obj_align(zmk_widget_output_status_obj(&layer_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
+    zmk_widget_layer_status_init(&layer_status_widget, main_obj);
+    // the layer name is cut off at CONFIG_ZMK_DONGLE_DISPLAY_LAYER_NAME_WIDTH to end at the right edge
+    lv_obj_align_to(zmk_widget_layer_status_obj(&layer_status_widget), zmk_widget_output_status_obj(&output_status_widget), LV_ALIGN_OUT_RIGHT_TOP, 4, 0);
     // lv_obj_align_to(zmk_widget_layer_status_obj(&layer_status_widget), zmk_widget_bongo_cat_obj(&bongo_cat_widget), LV_ALIGN_BOTTOM_LEFT, 0, 5);
 
-    zmk_widget_peripheral_battery_status_init(&peripheral_battery_status_widget, screen);
+    zmk_widget_peripheral_battery_status_init(&peripheral_battery_status_widget, main_obj);
     lv_obj_align(zmk_widget_peripheral_battery_status_obj(&peripheral_battery_status_widget), LV_ALIGN_BOTTOM_RIGHT, 0, 0);
 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_PAGE)
+    zmk_widget_link_health_init(&link_health_widget,
+                                dongle_page_add(&link_health_page, screen, "link",
+                                                zmk_widget_link_health_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CONN_INTERVAL_PAGE)
+    zmk_widget_conn_interval_init(&conn_interval_widget,
+                                  dongle_page_add(&conn_interval_page, screen, "conn",
+                                                  zmk_widget_conn_interval_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SPLIT_JITTER_PAGE)
+    zmk_widget_split_jitter_init(&split_jitter_widget,
+                                 dongle_page_add(&split_jitter_page, screen, "jitter",
+                                                 zmk_widget_split_jitter_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_DECISION_LATENCY_PAGE)
+    zmk_widget_decision_latency_init(&decision_latency_widget,
+                                     dongle_page_add(&decision_latency_page, screen, "decision",
+                                                     zmk_widget_decision_latency_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_MATRIX_PAGE)
+    zmk_widget_key_matrix_init(&key_matrix_widget,
+                               dongle_page_add(&key_matrix_page, screen, "keys", NULL));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_KEY_STATS_PAGE)
+    zmk_widget_key_stats_init(&key_stats_widget,
+                              dongle_page_add(&key_stats_page, screen, "keystats",
+                                              zmk_widget_key_stats_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TELEMETRY_PAGE)
+    zmk_widget_telemetry_init(&telemetry_widget,
+                              dongle_page_add(&telemetry_page, screen, "telemetry",
+                                              zmk_widget_telemetry_refresh));
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP)
+    display_sleep_init();
+#endif
+
     return screen;
 }
\ No newline at end of file
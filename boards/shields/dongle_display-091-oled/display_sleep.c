@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/atomic.h>
+#include <lvgl.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#include <zmk/usb.h>
+
+#include "display_sleep.h"
+#include "stats/oled_power.h"
+
+// ZMK's idle blanking would switch the panel on behind the back of the reasons below
+BUILD_ASSERT(!IS_ENABLED(CONFIG_ZMK_DISPLAY_BLANK_ON_IDLE),
+             "CONFIG_ZMK_DONGLE_DISPLAY_SLEEP replaces CONFIG_ZMK_DISPLAY_BLANK_ON_IDLE");
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+// only the display work queue changes these
+static atomic_t asleep;
+static struct display_sleep_stats stats;
+
+// the panel sleeps while any reason is set
+static atomic_t reasons;
+
+// cycle count of the key press that asked for the wake, 0 while none is pending
+static atomic_t wake_requested_at;
+
+// The panel keeps its GDDRAM while it is off, so switching it off is a single command. LVGL keeps
+// all of its objects, its timers are only stopped, which also stops animations, and the
+// invalidated areas pile up meanwhile.
+static void display_sleep(lv_disp_t *disp) {
+    atomic_clear(&wake_requested_at);
+    lv_timer_enable(false);
+    display_blanking_on(display);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_POWER)
+    oled_power_set_panel_on(false);
+#endif
+
+    atomic_set(&asleep, true);
+    stats.sleeps++;
+}
+
+// The areas invalidated while asleep are flushed before the panel is switched on, so the first
+// visible frame is already up to date and nothing else is redrawn.
+static void display_wake(lv_disp_t *disp) {
+    uint32_t requested_at = atomic_clear(&wake_requested_at);
+
+    lv_timer_enable(true);
+    lv_refr_now(disp);
+    display_blanking_off(display);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_POWER)
+    oled_power_set_panel_on(true);
+#endif
+
+    atomic_set(&asleep, false);
+
+    // wakes without a key press, like a USB resume, have no latency to report
+    if (requested_at != 0) {
+        stats.last_wake_us = k_cyc_to_us_near32(k_cycle_get_32() - requested_at);
+        stats.max_wake_us = MAX(stats.max_wake_us, stats.last_wake_us);
+    }
+}
+
+static void sleep_update_work_cb(struct k_work *work) {
+    lv_disp_t *disp = lv_disp_get_default();
+    bool should_sleep = atomic_get(&reasons) != 0;
+
+    if (disp == NULL || should_sleep == (bool)atomic_get(&asleep)) {
+        return;
+    }
+
+    if (should_sleep) {
+        display_sleep(disp);
+    } else {
+        display_wake(disp);
+    }
+}
+
+static K_WORK_DEFINE(sleep_update_work, sleep_update_work_cb);
+
+static void set_reason(enum display_sleep_reason reason, bool set) {
+    if (set) {
+        atomic_set_bit(&reasons, reason);
+    } else {
+        atomic_clear_bit(&reasons, reason);
+    }
+
+    k_work_submit_to_queue(zmk_display_work_q(), &sleep_update_work);
+}
+
+#if CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_SECONDS > 0
+static void idle_work_cb(struct k_work *work) { set_reason(DISPLAY_SLEEP_IDLE, true); }
+
+static K_WORK_DELAYABLE_DEFINE(idle_work, idle_work_cb);
+
+static int display_sleep_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL || !ev->state) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_work_reschedule(&idle_work, K_SECONDS(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_SECONDS));
+
+    if (!atomic_test_and_clear_bit(&reasons, DISPLAY_SLEEP_IDLE)) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // The first press while asleep is the one the latency is measured from, the low bit keeps
+    // the cycle count from reading as no request. A press that leaves the panel asleep for
+    // another reason, like a suspended host, is not what wakes it later.
+    if (atomic_get(&reasons) == 0) {
+        atomic_cas(&wake_requested_at, 0, k_cycle_get_32() | 1);
+    }
+    k_work_submit_to_queue(zmk_display_work_q(), &sleep_update_work);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(display_sleep_position, display_sleep_position_listener);
+ZMK_SUBSCRIPTION(display_sleep_position, zmk_position_state_changed);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_ON_USB_SUSPEND)
+// a suspended host resumes on its own when a key press wakes it, so key presses leave this alone
+static int display_sleep_usb_listener(const zmk_event_t *eh) {
+    set_reason(DISPLAY_SLEEP_USB_SUSPEND, zmk_usb_get_status() == USB_DC_SUSPEND);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(display_sleep_usb, display_sleep_usb_listener);
+ZMK_SUBSCRIPTION(display_sleep_usb, zmk_usb_conn_state_changed);
+#endif
+
+void display_sleep_init(void) {
+#if CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_SECONDS > 0
+    k_work_reschedule(&idle_work, K_SECONDS(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_SECONDS));
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_SLEEP_ON_USB_SUSPEND)
+    set_reason(DISPLAY_SLEEP_USB_SUSPEND, zmk_usb_get_status() == USB_DC_SUSPEND);
+#endif
+}
+
+void display_sleep_get_stats(struct display_sleep_stats *out) {
+    *out = stats;
+    out->asleep = atomic_get(&asleep);
+    out->reasons = atomic_get(&reasons);
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static uint32_t full_redraw_us;
+
+// what a wake would cost if the whole status screen was rendered again
+static void full_redraw_work_cb(struct k_work *work) {
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp == NULL || atomic_get(&asleep)) {
+        return;
+    }
+
+    uint32_t start = k_cycle_get_32();
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+    full_redraw_us = k_cyc_to_us_near32(k_cycle_get_32() - start);
+}
+
+static K_WORK_DEFINE(full_redraw_work, full_redraw_work_cb);
+
+static int cmd_sleep_show(const struct shell *sh, size_t argc, char **argv) {
+    struct display_sleep_stats s;
+    display_sleep_get_stats(&s);
+
+    shell_print(sh, "%s%s%s, %u sleeps, wake %u us (max %u us)", s.asleep ? "asleep" : "awake",
+                (s.reasons & BIT(DISPLAY_SLEEP_IDLE)) ? " idle" : "",
+                (s.reasons & BIT(DISPLAY_SLEEP_USB_SUSPEND)) ? " usb-suspend" : "", s.sleeps,
+                s.last_wake_us, s.max_wake_us);
+    return 0;
+}
+
+static int cmd_sleep_compare(const struct shell *sh, size_t argc, char **argv) {
+    struct k_work_sync sync;
+    struct display_sleep_stats s;
+
+    k_work_submit_to_queue(zmk_display_work_q(), &full_redraw_work);
+    k_work_flush(&full_redraw_work, &sync);
+    display_sleep_get_stats(&s);
+
+    if (s.asleep) {
+        shell_error(sh, "Display is asleep, press a key first");
+        return -EAGAIN;
+    }
+
+    shell_print(sh, "last wake %u us, full redraw %u us", s.last_wake_us, full_redraw_us);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_sleep,
+                               SHELL_CMD(show, NULL, "Show sleep state and wake latency",
+                                         cmd_sleep_show),
+                               SHELL_CMD(compare, NULL,
+                                         "Compare the last wake with a full status screen redraw",
+                                         cmd_sleep_compare),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), sleep, &sub_sleep, "Display sleep", NULL, 1, 0);
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+enum display_sleep_reason {
+    // no key press for the configured time, cleared by the next press
+    DISPLAY_SLEEP_IDLE,
+    // the USB host suspended the bus, cleared when it resumes
+    DISPLAY_SLEEP_USB_SUSPEND,
+};
+
+struct display_sleep_stats {
+    bool asleep;
+    // bit set of enum display_sleep_reason
+    uint32_t reasons;
+    uint32_t sleeps;
+    // from the key press to the panel being back on, in microseconds
+    uint32_t last_wake_us;
+    uint32_t max_wake_us;
+};
+
+// must be called on the display work queue once the status screen exists
+void display_sleep_init(void);
+void display_sleep_get_stats(struct display_sleep_stats *stats);
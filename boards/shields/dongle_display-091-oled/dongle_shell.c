@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/shell/shell.h>
+
+// Root of the dongle shell commands, subcommands are added with SHELL_SUBCMD_ADD((dongle), ...)
+SHELL_SUBCMD_SET_CREATE(sub_dongle, (dongle));
+SHELL_CMD_REGISTER(dongle, &sub_dongle, "Dongle display commands", NULL);
@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include "local_wpm_changed.h"
+
+ZMK_EVENT_IMPL(zmk_local_wpm_changed);
@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/event_manager.h>
+
+struct zmk_local_wpm_changed {
+    uint8_t state;
+};
+
+ZMK_EVENT_DECLARE(zmk_local_wpm_changed);
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/usb/usb_device.h>
+#include <zephyr/usb/class/usb_hid.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "hid_fb.h"
+#include "stats/frame_capture.h"
+#include "stats/oled_power.h"
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+#include "stats/host_time.h"
+#include "widgets/clock.h"
+#endif
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+#define PANEL_WIDTH DT_PROP(DISPLAY_NODE, width)
+#define PANEL_PAGES (DT_PROP(DISPLAY_NODE, height) / 8)
+
+static const struct device *display = DEVICE_DT_GET(DISPLAY_NODE);
+static const struct device *hid_dev;
+
+// Only the display work queue touches the panel.
+static uint8_t staging[PANEL_PAGES][PANEL_WIDTH];
+static uint8_t shown[PANEL_PAGES][PANEL_WIDTH];
+static struct hid_fb_panel panel = {
+    .staging = &staging[0][0],
+    .shown = &shown[0][0],
+    .width = PANEL_WIDTH,
+    .pages = PANEL_PAGES,
+};
+
+// counted in the USB callbacks, everything else on the display work queue
+static atomic_t dropped;
+
+K_MSGQ_DEFINE(hid_fb_msgq, HID_FB_REPORT_SIZE, CONFIG_ZMK_DONGLE_DISPLAY_RAW_HID_QUEUE, 4);
+
+static const uint8_t hid_fb_report_desc[] = {
+    0x06, 0x60, 0xff, // usage page (vendor defined 0xff60)
+    HID_USAGE(0x61),
+    HID_COLLECTION(HID_COLLECTION_APPLICATION),
+    HID_USAGE(0x62),
+    HID_LOGICAL_MIN8(0x00),
+    HID_LOGICAL_MAX16(0xff, 0x00),
+    HID_REPORT_SIZE(8),
+    HID_REPORT_COUNT(HID_FB_REPORT_SIZE),
+    HID_INPUT(0x02),
+    HID_USAGE(0x63),
+    HID_LOGICAL_MIN8(0x00),
+    HID_LOGICAL_MAX16(0xff, 0x00),
+    HID_REPORT_SIZE(8),
+    HID_REPORT_COUNT(HID_FB_REPORT_SIZE),
+    HID_OUTPUT(0x02),
+    HID_END_COLLECTION,
+};
+
+static lv_area_t region_area(const struct hid_fb_region *r) {
+    struct hid_fb_area a = hid_fb_region_area(r);
+
+    return (lv_area_t){.x1 = a.x1, .y1 = a.y1, .x2 = a.x2, .y2 = a.y2};
+}
+
+static void push_region(const struct hid_fb_region *r) {
+    static uint8_t buf[PANEL_PAGES * PANEL_WIDTH];
+    struct display_buffer_descriptor desc = {
+        .buf_size = r->width * r->pages,
+        .width = r->width,
+        .height = r->pages * 8,
+        .pitch = r->width,
+    };
+
+    for (int p = 0; p < r->pages; p++) {
+        memcpy(&buf[p * r->width], &shown[r->page + p][r->x], r->width);
+    }
+
+    int err = display_write(display, r->x, r->page * 8, &desc, buf);
+    if (err) {
+        LOG_WRN("Failed to write host region to the panel (err %d)", err);
+        return;
+    }
+
+    // LVGL never sees these writes, so the flush recorders get them here
+    lv_area_t area = region_area(r);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_FRAME_CAPTURE)
+    frame_capture_record(&area, buf);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_POWER)
+    oled_power_record_flush(&area, buf);
+#endif
+}
+
+static void invalidate_region(const struct hid_fb_region *r) {
+    lv_area_t area = region_area(r);
+    lv_obj_invalidate_area(lv_scr_act(), &area);
+}
+
+static int claim(const uint8_t *report) {
+    struct hid_fb_region previous;
+
+    int err = hid_fb_panel_claim(&panel, report, &previous);
+    if (err) {
+        return err;
+    }
+
+    if (previous.claimed) {
+        invalidate_region(&previous);
+    }
+
+    push_region(&panel.regions[report[3]]);
+    return 0;
+}
+
+static int release(const uint8_t *report) {
+    uint8_t released;
+
+    int err = hid_fb_panel_release(&panel, report, &released);
+    if (err) {
+        return err;
+    }
+
+    for (int i = 0; i < HID_FB_REGIONS; i++) {
+        if (released & BIT(i)) {
+            invalidate_region(&panel.regions[i]);
+        }
+    }
+
+    return 0;
+}
+
+static int write_region(const uint8_t *report) {
+    bool committed;
+
+    int err = hid_fb_panel_write(&panel, report, &committed);
+    if (err) {
+        return err;
+    }
+
+    if (committed) {
+        push_region(&panel.regions[report[3]]);
+    }
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+static int set_time(const uint8_t *report) {
+    host_time_set(sys_get_le64(&report[4]), (int16_t)sys_get_le16(&report[12]));
+    zmk_widget_clock_refresh();
+    return 0;
+}
+#endif
+
+// err is 0 or a negative errno, the reply carries it positive
+static void reply(const uint8_t *report, int err) {
+    uint8_t out[HID_FB_REPORT_SIZE] = {0x80 | report[0], (uint8_t)-err, report[2]};
+
+    if (report[0] == HID_FB_CMD_STATUS) {
+        sys_put_le32(panel.counters.received, &out[4]);
+        sys_put_le32(atomic_get(&dropped), &out[8]);
+        sys_put_le32(panel.counters.sequence_gaps, &out[12]);
+        sys_put_le32(panel.counters.errors, &out[16]);
+        sys_put_le32(panel.counters.commits, &out[20]);
+    }
+
+    err = hid_int_ep_write(hid_dev, out, sizeof(out), NULL);
+    if (err) {
+        LOG_DBG("Failed to send raw HID reply (err %d)", err);
+    }
+}
+
+static void hid_fb_work_cb(struct k_work *work) {
+    uint8_t report[HID_FB_REPORT_SIZE];
+
+    while (k_msgq_get(&hid_fb_msgq, report, K_NO_WAIT) == 0) {
+        int err;
+
+        hid_fb_panel_receive(&panel, report);
+
+        switch (report[0]) {
+        case HID_FB_CMD_CLAIM:
+            err = claim(report);
+            break;
+        case HID_FB_CMD_RELEASE:
+            err = release(report);
+            break;
+        case HID_FB_CMD_WRITE:
+            err = write_region(report);
+            break;
+        case HID_FB_CMD_STATUS:
+            err = 0;
+            break;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+        case HID_FB_CMD_TIME:
+            err = set_time(report);
+            break;
+#endif
+        default:
+            err = -ENOTSUP;
+            break;
+        }
+
+        if (err) {
+            panel.counters.errors++;
+        }
+
+        if (report[0] == HID_FB_CMD_STATUS || (report[1] & HID_FB_FLAG_ACK) || err) {
+            reply(report, err);
+        }
+    }
+}
+
+static K_WORK_DEFINE(hid_fb_work, hid_fb_work_cb);
+
+static void queue_report(const uint8_t *data, size_t len) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {};
+
+    memcpy(report, data, MIN(len, sizeof(report)));
+    if (k_msgq_put(&hid_fb_msgq, report, K_NO_WAIT) != 0) {
+        atomic_inc(&dropped);
+        return;
+    }
+
+    k_work_submit_to_queue(zmk_display_work_q(), &hid_fb_work);
+}
+
+// without CONFIG_ENABLE_HID_INT_OUT_EP hosts send output reports as SET_REPORT requests
+static int hid_fb_set_report(const struct device *dev, struct usb_setup_packet *setup,
+                             int32_t *len, uint8_t **data) {
+    queue_report(*data, *len);
+    return 0;
+}
+
+static void hid_fb_int_out_ready(const struct device *dev) {
+    uint8_t report[HID_FB_REPORT_SIZE];
+    uint32_t read = 0;
+
+    if (hid_int_ep_read(dev, report, sizeof(report), &read) == 0 && read > 0) {
+        queue_report(report, read);
+    }
+}
+
+static const struct hid_ops hid_fb_ops = {
+    .set_report = hid_fb_set_report,
+    .int_out_ready = hid_fb_int_out_ready,
+};
+
+void hid_fb_patch_flush(const lv_area_t *area, uint8_t *buf) {
+    struct hid_fb_area a = {.x1 = area->x1, .y1 = area->y1, .x2 = area->x2, .y2 = area->y2};
+
+    hid_fb_panel_patch_flush(&panel, &a, buf);
+}
+
+// registered before ZMK enables USB, next to its own HID instance
+static int hid_fb_init(void) {
+    struct display_capabilities caps;
+
+    display_get_capabilities(display, &caps);
+    if (!(caps.screen_info & SCREEN_INFO_MONO_VTILED)) {
+        LOG_ERR("The raw HID framebuffer needs a panel with vertically tiled pages");
+        return -ENOTSUP;
+    }
+
+    hid_dev = device_get_binding("HID_1");
+    if (hid_dev == NULL) {
+        LOG_ERR("No second USB HID instance for the raw HID framebuffer");
+        return -ENODEV;
+    }
+
+    usb_hid_register_device(hid_dev, hid_fb_report_desc, sizeof(hid_fb_report_desc), &hid_fb_ops);
+    return usb_hid_init(hid_dev);
+}
+
+SYS_INIT(hid_fb_init, APPLICATION, CONFIG_ZMK_USB_HID_INIT_PRIORITY);
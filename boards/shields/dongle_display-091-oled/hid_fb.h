@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#include "hid_fb_regions.h"
+
+// Replies have 0x80 | command in [0], the status (0 or a positive errno) in [1] and the sequence
+// number of the command in [2]. The status reply carries, little endian from [4] on, received,
+// dropped, sequence gaps, errors and commits.
+
+// Host regions win over LVGL: their pixels are copied into every area LVGL flushes.
+void hid_fb_patch_flush(const lv_area_t *area, uint8_t *buf);
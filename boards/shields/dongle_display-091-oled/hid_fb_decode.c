@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "hid_fb_decode.h"
+
+#define PAYLOAD_OFFSET 8
+
+// kept free of Zephyr so scripts/tests can check it on the host
+static size_t view_index(const struct hid_fb_view *view, uint32_t offset) {
+    return (size_t)(offset / view->width) * view->pitch + offset % view->width;
+}
+
+int hid_fb_decode_write(const struct hid_fb_view *view, const uint8_t *report) {
+    uint8_t encoding = report[4];
+    uint32_t offset = report[5] | report[6] << 8;
+    uint8_t len = report[7];
+    const uint8_t *payload = &report[PAYLOAD_OFFSET];
+    uint32_t size = (uint32_t)view->width * view->pages;
+
+    if (len > HID_FB_REPORT_SIZE - PAYLOAD_OFFSET) {
+        return -EINVAL;
+    }
+
+    if (encoding == HID_FB_ENC_RAW) {
+        if (offset + len > size) {
+            return -EINVAL;
+        }
+
+        for (int i = 0; i < len; i++) {
+            view->staging[view_index(view, offset + i)] = payload[i];
+        }
+    } else if (encoding == HID_FB_ENC_RLE || encoding == HID_FB_ENC_DELTA) {
+        uint32_t end = offset;
+
+        if (len % 2) {
+            return -EINVAL;
+        }
+
+        // every run is checked before the first one is written, a rejected report leaves staging
+        // as it was
+        for (int i = 0; i < len; i += 2) {
+            end += payload[i];
+        }
+        if (end > size) {
+            return -EINVAL;
+        }
+
+        for (int i = 0; i < len; i += 2) {
+            uint8_t count = payload[i], value = payload[i + 1];
+
+            for (; count > 0; count--, offset++) {
+                size_t index = view_index(view, offset);
+                view->staging[index] =
+                    encoding == HID_FB_ENC_DELTA ? view->shown[index] ^ value : value;
+            }
+        }
+    } else {
+        return -ENOTSUP;
+    }
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Every report is 64 bytes, see scripts/dongle_hid.py for the host side.
+#define HID_FB_REPORT_SIZE 64
+
+enum hid_fb_encoding {
+    HID_FB_ENC_RAW,
+    // (count, byte) pairs
+    HID_FB_ENC_RLE,
+    // (count, byte) pairs XORed onto what the region shows now
+    HID_FB_ENC_DELTA,
+};
+
+// One claimed region in both buffers: the first byte of the region, with its pages pitch bytes
+// apart. Region bytes are numbered page by page, left to right.
+struct hid_fb_view {
+    uint8_t *staging;
+    const uint8_t *shown;
+    uint16_t pitch;
+    uint16_t width;
+    uint16_t pages;
+};
+
+// Decodes the payload of a write report into the staging bytes of the region. Returns 0, or
+// -EINVAL or -ENOTSUP without touching staging when any part of the payload does not fit.
+int hid_fb_decode_write(const struct hid_fb_view *view, const uint8_t *report);
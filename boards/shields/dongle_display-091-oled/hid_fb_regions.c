@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "hid_fb_regions.h"
+
+// kept free of Zephyr like hid_fb_decode.c, so scripts/tests can check it on the host
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+static uint8_t *panel_byte(uint8_t *buf, const struct hid_fb_panel *panel, int page, int x) {
+    return &buf[page * panel->width + x];
+}
+
+struct hid_fb_area hid_fb_region_area(const struct hid_fb_region *r) {
+    return (struct hid_fb_area){
+        .x1 = r->x,
+        .y1 = r->page * 8,
+        .x2 = r->x + r->width - 1,
+        .y2 = (r->page + r->pages) * 8 - 1,
+    };
+}
+
+void hid_fb_panel_receive(struct hid_fb_panel *panel, const uint8_t *report) {
+    if (panel->counters.received > 0 && report[2] != (uint8_t)(panel->last_seq + 1)) {
+        panel->counters.sequence_gaps++;
+    }
+    panel->last_seq = report[2];
+    panel->counters.received++;
+}
+
+int hid_fb_panel_claim(struct hid_fb_panel *panel, const uint8_t *report,
+                       struct hid_fb_region *previous) {
+    uint8_t id = report[3];
+    struct hid_fb_region r = {
+        .claimed = true, .x = report[4], .page = report[5], .width = report[6], .pages = report[7]};
+
+    if (id >= HID_FB_REGIONS || r.width == 0 || r.pages == 0 || r.x + r.width > panel->width ||
+        r.page + r.pages > panel->pages) {
+        return -EINVAL;
+    }
+
+    *previous = panel->regions[id];
+
+    for (int p = r.page; p < r.page + r.pages; p++) {
+        memset(panel_byte(panel->staging, panel, p, r.x), 0, r.width);
+        memset(panel_byte(panel->shown, panel, p, r.x), 0, r.width);
+    }
+
+    panel->regions[id] = r;
+    return 0;
+}
+
+int hid_fb_panel_release(struct hid_fb_panel *panel, const uint8_t *report, uint8_t *released) {
+    uint8_t id = report[3];
+
+    *released = 0;
+
+    if (id != HID_FB_REGION_ALL && id >= HID_FB_REGIONS) {
+        return -EINVAL;
+    }
+
+    for (int i = 0; i < HID_FB_REGIONS; i++) {
+        if ((id == HID_FB_REGION_ALL || id == i) && panel->regions[i].claimed) {
+            panel->regions[i].claimed = false;
+            *released |= 1 << i;
+        }
+    }
+
+    return 0;
+}
+
+int hid_fb_panel_write(struct hid_fb_panel *panel, const uint8_t *report, bool *committed) {
+    uint8_t id = report[3];
+
+    *committed = false;
+
+    if (id >= HID_FB_REGIONS || !panel->regions[id].claimed) {
+        return -EINVAL;
+    }
+
+    const struct hid_fb_region *r = &panel->regions[id];
+    struct hid_fb_view view = {
+        .staging = panel_byte(panel->staging, panel, r->page, r->x),
+        .shown = panel_byte(panel->shown, panel, r->page, r->x),
+        .pitch = panel->width,
+        .width = r->width,
+        .pages = r->pages,
+    };
+
+    int err = hid_fb_decode_write(&view, report);
+    if (err) {
+        return err;
+    }
+
+    if (report[1] & HID_FB_FLAG_COMMIT) {
+        for (int p = r->page; p < r->page + r->pages; p++) {
+            memcpy(panel_byte(panel->shown, panel, p, r->x),
+                   panel_byte(panel->staging, panel, p, r->x), r->width);
+        }
+        panel->counters.commits++;
+        *committed = true;
+    }
+
+    return 0;
+}
+
+void hid_fb_panel_patch_flush(const struct hid_fb_panel *panel, const struct hid_fb_area *area,
+                              uint8_t *buf) {
+    int w = area->x2 - area->x1 + 1;
+
+    // LVGL flushes whole pages to this panel, see the rounder of the LVGL module
+    if (area->y1 % 8 != 0) {
+        return;
+    }
+
+    for (int i = 0; i < HID_FB_REGIONS; i++) {
+        const struct hid_fb_region *r = &panel->regions[i];
+        if (!r->claimed) {
+            continue;
+        }
+
+        int p1 = MAX(r->page, area->y1 / 8), p2 = MIN(r->page + r->pages - 1, area->y2 / 8);
+        int x1 = MAX(r->x, area->x1), x2 = MIN(r->x + r->width - 1, area->x2);
+
+        for (int p = p1; p <= p2 && x1 <= x2; p++) {
+            memcpy(&buf[(p - area->y1 / 8) * w + x1 - area->x1],
+                   panel_byte(panel->shown, panel, p, x1), x2 - x1 + 1);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hid_fb_decode.h"
+
+#define HID_FB_REGIONS 4
+#define HID_FB_REGION_ALL 0xff
+
+enum hid_fb_command {
+    // [3] region, [4] x, [5] first page, [6] width, [7] pages; the region is cleared and shown
+    HID_FB_CMD_CLAIM = 0x01,
+    // [3] region or 0xff for all; LVGL redraws what was underneath
+    HID_FB_CMD_RELEASE = 0x02,
+    // [3] region, [4] encoding, [5..6] byte offset in the region, [7] payload length, [8..] payload
+    HID_FB_CMD_WRITE = 0x03,
+    // always answered with the counters below
+    HID_FB_CMD_STATUS = 0x04,
+    // [4..11] UTC milliseconds since the epoch, [12..13] signed UTC offset of the host in minutes
+    HID_FB_CMD_TIME = 0x05,
+};
+
+// [1] of every command
+#define HID_FB_FLAG_ACK (1 << 0)
+// after this write the region is pushed to the panel
+#define HID_FB_FLAG_COMMIT (1 << 1)
+
+struct hid_fb_region {
+    bool claimed;
+    uint8_t x;
+    uint8_t page;
+    uint8_t width;
+    uint8_t pages;
+};
+
+// pixels, both corners included like lv_area_t
+struct hid_fb_area {
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+};
+
+// counted on the display work queue; the reports the USB callbacks drop are counted in hid_fb.c
+struct hid_fb_counters {
+    uint32_t received;
+    uint32_t sequence_gaps;
+    uint32_t errors;
+    uint32_t commits;
+};
+
+// Both buffers are in the panel memory layout, width bytes per page. Writes land in staging, a
+// commit copies the region to shown, which is what the panel and every LVGL flush get.
+struct hid_fb_panel {
+    uint8_t *staging;
+    uint8_t *shown;
+    uint16_t width;
+    uint16_t pages;
+    struct hid_fb_region regions[HID_FB_REGIONS];
+    struct hid_fb_counters counters;
+    uint8_t last_seq;
+};
+
+struct hid_fb_area hid_fb_region_area(const struct hid_fb_region *r);
+
+// Counts a report and a gap in the sequence numbers before it. A streaming host never waits for
+// replies, so gaps show reports lost on the way.
+void hid_fb_panel_receive(struct hid_fb_panel *panel, const uint8_t *report);
+
+// Claims the region of the report and clears it in both buffers. previous is what the region
+// was before, to invalidate an old area it no longer covers. Returns 0 or -EINVAL.
+int hid_fb_panel_claim(struct hid_fb_panel *panel, const uint8_t *report,
+                       struct hid_fb_region *previous);
+// released gets a bit for every region that was claimed until now, their geometry is kept so
+// the area LVGL has to redraw can still be taken from them. Returns 0 or -EINVAL.
+int hid_fb_panel_release(struct hid_fb_panel *panel, const uint8_t *report, uint8_t *released);
+// Decodes a write into staging and, with HID_FB_FLAG_COMMIT, copies the region to shown and sets
+// committed. Returns 0, -EINVAL or -ENOTSUP.
+int hid_fb_panel_write(struct hid_fb_panel *panel, const uint8_t *report, bool *committed);
+
+// Copies the shown pixels of every claimed region into an LVGL flush of area, whose buf holds
+// whole pages in the panel memory layout.
+void hid_fb_panel_patch_flush(const struct hid_fb_panel *panel, const struct hid_fb_area *area,
+                              uint8_t *buf);
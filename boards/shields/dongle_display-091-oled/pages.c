@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "pages.h"
+#include "stats/bench.h"
+
+static sys_slist_t pages = SYS_SLIST_STATIC_INIT(&pages);
+
+static struct dongle_page *current_page;
+static struct dongle_page *requested_page;
+
+static void page_refresh_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(page_refresh_work, page_refresh_work_cb);
+
+DONGLE_BENCH_DEFINE(page_refresh);
+
+static void page_refresh_work_cb(struct k_work *work) {
+    if (current_page == NULL || current_page->refresh == NULL) {
+        return;
+    }
+
+    DONGLE_BENCH_BEGIN(page_refresh);
+    current_page->refresh();
+    DONGLE_BENCH_END(page_refresh);
+    k_work_schedule_for_queue(zmk_display_work_q(), &page_refresh_work,
+                              K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_PAGE_REFRESH_MS));
+}
+
+// must run on the display work queue
+static void set_current_page(struct dongle_page *page) {
+    if (page == current_page) {
+        return;
+    }
+
+    struct dongle_page *p;
+    SYS_SLIST_FOR_EACH_CONTAINER(&pages, p, node) {
+        if (p == page) {
+            lv_obj_clear_flag(p->obj, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(p->obj, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+
+    current_page = page;
+
+    if (page->refresh != NULL) {
+        page->refresh();
+        k_work_schedule_for_queue(zmk_display_work_q(), &page_refresh_work,
+                                  K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_PAGE_REFRESH_MS));
+    } else {
+        k_work_cancel_delayable(&page_refresh_work);
+    }
+}
+
+static void page_show_work_cb(struct k_work *work) {
+    struct dongle_page *page = requested_page;
+    if (page != NULL) {
+        set_current_page(page);
+    }
+}
+
+static K_WORK_DEFINE(page_show_work, page_show_work_cb);
+
+#if CONFIG_ZMK_DONGLE_DISPLAY_PAGE_CYCLE_SECONDS > 0
+static void page_cycle_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(page_cycle_work, page_cycle_work_cb);
+
+static void page_cycle_work_cb(struct k_work *work) {
+    sys_snode_t *next = current_page != NULL ? sys_slist_peek_next(&current_page->node) : NULL;
+    if (next == NULL) {
+        next = sys_slist_peek_head(&pages);
+    }
+
+    if (next != NULL) {
+        set_current_page(CONTAINER_OF(next, struct dongle_page, node));
+    }
+
+    k_work_schedule_for_queue(zmk_display_work_q(), &page_cycle_work,
+                              K_SECONDS(CONFIG_ZMK_DONGLE_DISPLAY_PAGE_CYCLE_SECONDS));
+}
+#endif
+
+lv_obj_t *dongle_page_add(struct dongle_page *page, lv_obj_t *screen, const char *name,
+                          void (*refresh)(void)) {
+    page->name = name;
+    page->refresh = refresh;
+    page->obj = lv_obj_create(screen);
+    lv_obj_set_size(page->obj, LV_PCT(100), LV_PCT(100));
+
+    // the first page added is the one shown at boot
+    if (sys_slist_is_empty(&pages)) {
+        current_page = page;
+#if CONFIG_ZMK_DONGLE_DISPLAY_PAGE_CYCLE_SECONDS > 0
+        k_work_schedule_for_queue(zmk_display_work_q(), &page_cycle_work,
+                                  K_SECONDS(CONFIG_ZMK_DONGLE_DISPLAY_PAGE_CYCLE_SECONDS));
+#endif
+    } else {
+        lv_obj_add_flag(page->obj, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    sys_slist_append(&pages, &page->node);
+
+    return page->obj;
+}
+
+int dongle_page_show(const char *name) {
+    struct dongle_page *page;
+    int index = 0;
+    char *end;
+    long requested_index = strtol(name, &end, 10);
+    bool by_index = *end == '\0';
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&pages, page, node) {
+        if ((by_index && index == requested_index) || (!by_index && strcmp(page->name, name) == 0)) {
+            requested_page = page;
+            k_work_submit_to_queue(zmk_display_work_q(), &page_show_work);
+            return 0;
+        }
+        index++;
+    }
+
+    return -ENOENT;
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_page(const struct shell *sh, size_t argc, char **argv) {
+    if (argc > 1) {
+        int err = dongle_page_show(argv[1]);
+        if (err) {
+            shell_error(sh, "No page %s", argv[1]);
+        }
+        return err;
+    }
+
+    struct dongle_page *page;
+    int index = 0;
+    SYS_SLIST_FOR_EACH_CONTAINER(&pages, page, node) {
+        shell_print(sh, "%c %d %s", page == current_page ? '*' : ' ', index++, page->name);
+    }
+
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((dongle), page, NULL, "List pages or show the page with the given name or index",
+                 cmd_page, 1, 1);
+#endif
@@ -0,0 +1,23 @@
+/*
+ *
+ * Copyright (c) 2024 The ZMK Contributors
+ * SPDX-License-Identifier: MIT
+ *
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct dongle_page {
+    sys_snode_t node;
+    const char *name;
+    lv_obj_t *obj;
+    // called periodically on the display work queue while the page is shown, may be NULL
+    void (*refresh)(void);
+};
+
+lv_obj_t *dongle_page_add(struct dongle_page *page, lv_obj_t *screen, const char *name,
+                          void (*refresh)(void));
+int dongle_page_show(const char *name);
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/bluetooth/conn.h>
+
+// The host links are peripheral role connections, only the split links are central role.
+static inline bool is_split_conn(struct bt_conn *conn, struct bt_conn_info *info) {
+    return bt_conn_get_info(conn, info) == 0 && info->type == BT_CONN_TYPE_LE &&
+           info->role == BT_CONN_ROLE_CENTRAL;
+}
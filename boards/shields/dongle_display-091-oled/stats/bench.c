@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include "bench.h"
+
+static sys_slist_t stats = SYS_SLIST_STATIC_INIT(&stats);
+static struct k_spinlock stats_lock;
+
+// Records come from the display work queue and from the event listeners without locking, a rare
+// lost update only skews the numbers. The shell just reads them.
+void dongle_bench_record(struct dongle_bench_stat *stat, uint32_t cycles) {
+    if (!stat->registered) {
+        k_spinlock_key_t key = k_spin_lock(&stats_lock);
+        if (!stat->registered) {
+            sys_slist_append(&stats, &stat->node);
+            stat->registered = true;
+        }
+        k_spin_unlock(&stats_lock, key);
+    }
+
+    stat->count++;
+    stat->last_cycles = cycles;
+    stat->total_cycles += cycles;
+    if (cycles > stat->max_cycles) {
+        stat->max_cycles = cycles;
+    }
+}
+
+static int cmd_bench_show(const struct shell *sh, size_t argc, char **argv) {
+    struct dongle_bench_stat *stat;
+
+    shell_print(sh, "%-24s %8s %8s %8s %8s", "stage", "count", "last_us", "avg_us", "max_us");
+    SYS_SLIST_FOR_EACH_CONTAINER(&stats, stat, node) {
+        uint32_t avg = stat->count > 0 ? (uint32_t)(stat->total_cycles / stat->count) : 0;
+
+        shell_print(sh, "%-24s %8u %8u %8u %8u", stat->name, stat->count,
+                    k_cyc_to_us_near32(stat->last_cycles), k_cyc_to_us_near32(avg),
+                    k_cyc_to_us_near32(stat->max_cycles));
+    }
+
+    return 0;
+}
+
+static int cmd_bench_reset(const struct shell *sh, size_t argc, char **argv) {
+    struct dongle_bench_stat *stat;
+
+    SYS_SLIST_FOR_EACH_CONTAINER(&stats, stat, node) {
+        stat->last_cycles = 0;
+        stat->max_cycles = 0;
+        stat->total_cycles = 0;
+        stat->count = 0;
+    }
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bench,
+                               SHELL_CMD(show, NULL, "Show per-update cost of each stage",
+                                         cmd_bench_show),
+                               SHELL_CMD(reset, NULL, "Reset recorded costs", cmd_bench_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), bench, &sub_bench, "Display update benchmarks", NULL, 1, 0);
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct dongle_bench_stat {
+    sys_snode_t node;
+    const char *name;
+    bool registered;
+    uint32_t count;
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TRACING)
+#include <zephyr/tracing/tracing.h>
+
+// Stage boundaries become CTF named events, arg0 is 0 on entry and 1 on exit. CTF keeps at most
+// 19 characters of the name, so stage names are kept short.
+#define DONGLE_TRACE_STAGE(_name, _exit) sys_trace_named_event(STRINGIFY(_name), _exit, 0)
+#else
+#define DONGLE_TRACE_STAGE(_name, _exit)
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BENCH)
+
+void dongle_bench_record(struct dongle_bench_stat *stat, uint32_t cycles);
+
+#define DONGLE_BENCH_DEFINE(_name)                                                                 \
+    static struct dongle_bench_stat _CONCAT(dongle_bench_, _name) = {.name = STRINGIFY(_name)}
+
+#define DONGLE_BENCH_BEGIN(_name)                                                                  \
+    DONGLE_TRACE_STAGE(_name, 0);                                                                  \
+    const uint32_t _CONCAT(dongle_bench_start_, _name) = k_cycle_get_32()
+
+#define DONGLE_BENCH_END(_name)                                                                    \
+    dongle_bench_record(&_CONCAT(dongle_bench_, _name),                                            \
+                        k_cycle_get_32() - _CONCAT(dongle_bench_start_, _name));                   \
+    DONGLE_TRACE_STAGE(_name, 1)
+
+#else
+
+#define DONGLE_BENCH_DEFINE(_name)
+#define DONGLE_BENCH_BEGIN(_name) DONGLE_TRACE_STAGE(_name, 0)
+#define DONGLE_BENCH_END(_name) DONGLE_TRACE_STAGE(_name, 1)
+
+#endif
+
+#define DONGLE_BENCH_DISPLAY_HOOKS                                                                 \
+    (IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BENCH) || IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_TRACING) ||  \
+     IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_FRAME_CAPTURE) ||                                         \
+     IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_POWER) ||                                            \
+     IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RAW_HID))
+
+#if DONGLE_BENCH_DISPLAY_HOOKS
+#include <lvgl.h>
+
+// wraps the LVGL refresh timer and the panel flush of the display in stages, and feeds the
+// flushed areas to the frame capture and the power estimate
+void dongle_bench_hook_display(lv_disp_t *disp);
+#endif
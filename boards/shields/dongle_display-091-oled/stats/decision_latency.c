@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "decision_latency.h"
+
+#define PENDING_EVENTS CONFIG_ZMK_DONGLE_DISPLAY_DECISION_LATENCY_PENDING
+#define MAX_MS CONFIG_ZMK_DONGLE_DISPLAY_DECISION_LATENCY_MAX_MS
+
+// a matched press is at most MAX_MS old, so the per position total cannot wrap before the count
+// is halved
+BUILD_ASSERT((uint64_t)UINT16_MAX * MAX_MS <= UINT32_MAX);
+
+// ZMK runs the listeners of modules after its own, so a press captured by a combo or hold-tap
+// is only seen here when it is released again, and not at all when a combo fires. Latencies are
+// therefore taken from the event timestamps instead: position events keep the time they were
+// raised at through capture and release, and behaviors raise their keycodes with the timestamp of
+// the press that triggered them, the first key for a combo.
+//
+// For the same reason the keycode of a plain key, raised from the keymap listener while its
+// position event is handled, reaches this listener before that position event. A keycode and its
+// press are therefore matched in either order, whichever arrives first waits for the other.
+struct pending_event {
+    int64_t timestamp;
+    // the position of a press, or the latency of a keycode in milliseconds
+    uint32_t value;
+};
+
+// events still waiting for their counterpart, oldest first
+struct pending_list {
+    struct pending_event events[PENDING_EVENTS];
+    uint8_t count;
+};
+
+static struct pending_list pending_presses;
+static struct pending_list pending_keycodes;
+
+static struct histogram overall;
+static struct decision_latency_position positions[ZMK_KEYMAP_LEN];
+
+static struct k_spinlock lock;
+
+static void pending_remove(struct pending_list *list, uint8_t index) {
+    memmove(&list->events[index], &list->events[index + 1],
+            (list->count - index - 1) * sizeof(list->events[0]));
+    list->count--;
+}
+
+// drops presses that never produced a keycode, like layer keys or combo partners, and keycodes
+// whose press never got here, like the ones of combos
+static void pending_expire(struct pending_list *list, int64_t now) {
+    while (list->count > 0 && now - list->events[0].timestamp > MAX_MS) {
+        pending_remove(list, 0);
+    }
+}
+
+static void pending_add(struct pending_list *list, int64_t timestamp, uint32_t value) {
+    if (list->count == PENDING_EVENTS) {
+        pending_remove(list, 0);
+    }
+
+    list->events[list->count++] = (struct pending_event){.timestamp = timestamp, .value = value};
+}
+
+// takes the oldest event with the timestamp out of the list, false if there is none
+static bool pending_take(struct pending_list *list, int64_t timestamp, uint32_t *value) {
+    for (int i = 0; i < list->count; i++) {
+        if (list->events[i].timestamp == timestamp) {
+            *value = list->events[i].value;
+            pending_remove(list, i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void record_position(uint32_t position, uint32_t latency_ms) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return;
+    }
+
+    struct decision_latency_position *stats = &positions[position];
+    if (stats->count == UINT16_MAX) {
+        stats->count /= 2;
+        stats->total /= 2;
+    }
+    stats->count++;
+    stats->total += latency_ms;
+    histogram_small_record(&stats->hist, latency_ms);
+}
+
+static void on_position_pressed(uint32_t position, int64_t timestamp) {
+    // the same press released again after a combo or hold-tap captured it
+    for (int i = 0; i < pending_presses.count; i++) {
+        if (pending_presses.events[i].value == position &&
+            pending_presses.events[i].timestamp == timestamp) {
+            return;
+        }
+    }
+
+    uint32_t latency_ms;
+    if (pending_take(&pending_keycodes, timestamp, &latency_ms)) {
+        record_position(position, latency_ms);
+    } else {
+        pending_add(&pending_presses, timestamp, position);
+    }
+}
+
+// a keycode belongs to the press with its timestamp; it counts towards the overall histogram
+// right away and towards its position once that press is seen
+static void on_keycode_pressed(int64_t timestamp, int64_t now) {
+    uint32_t latency_ms = (uint32_t)MIN(now - timestamp, UINT32_MAX);
+    uint32_t position;
+
+    histogram_record(&overall, latency_ms);
+
+    if (pending_take(&pending_presses, timestamp, &position)) {
+        record_position(position, latency_ms);
+    } else {
+        pending_add(&pending_keycodes, timestamp, latency_ms);
+    }
+}
+
+static int decision_latency_listener(const zmk_event_t *eh) {
+    int64_t now = k_uptime_get();
+
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev != NULL) {
+        if (pos_ev->state) {
+            k_spinlock_key_t key = k_spin_lock(&lock);
+            pending_expire(&pending_presses, now);
+            pending_expire(&pending_keycodes, now);
+            on_position_pressed(pos_ev->position, pos_ev->timestamp);
+            k_spin_unlock(&lock, key);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_keycode_state_changed *kc_ev = as_zmk_keycode_state_changed(eh);
+    if (kc_ev != NULL && kc_ev->state) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        pending_expire(&pending_presses, now);
+        pending_expire(&pending_keycodes, now);
+        on_keycode_pressed(kc_ev->timestamp, now);
+        k_spin_unlock(&lock, key);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_decision_latency, decision_latency_listener);
+ZMK_SUBSCRIPTION(dongle_decision_latency, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(dongle_decision_latency, zmk_keycode_state_changed);
+
+void decision_latency_get_overall(struct histogram *hist) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *hist = overall;
+    k_spin_unlock(&lock, key);
+}
+
+int decision_latency_get_position(uint32_t position, struct decision_latency_position *stats) {
+    if (position >= ZMK_KEYMAP_LEN) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *stats = positions[position];
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+int decision_latency_slowest_position(uint32_t *position, uint32_t *avg) {
+    int err = -ENODATA;
+
+    *avg = 0;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        if (positions[i].count > 0 && positions[i].total / positions[i].count >= *avg) {
+            *avg = positions[i].total / positions[i].count;
+            *position = i;
+            err = 0;
+        }
+    }
+    k_spin_unlock(&lock, key);
+
+    return err;
+}
+
+void decision_latency_reset(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    histogram_reset(&overall);
+    memset(positions, 0, sizeof(positions));
+    pending_presses.count = 0;
+    pending_keycodes.count = 0;
+    k_spin_unlock(&lock, key);
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_decision_show(const struct shell *sh, size_t argc, char **argv) {
+    struct histogram hist;
+    decision_latency_get_overall(&hist);
+
+    shell_print(sh, "all positions: count %u, p50 %u ms, p99 %u ms, max %u ms", hist.count,
+                histogram_percentile(&hist, 50), histogram_percentile(&hist, 99), hist.max);
+
+    shell_print(sh, "%8s %8s %8s %8s %8s %8s", "position", "count", "avg_ms", "p50_ms", "p99_ms",
+                "max_ms");
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        struct decision_latency_position stats;
+        decision_latency_get_position(i, &stats);
+
+        if (stats.count > 0) {
+            shell_print(sh, "%8d %8u %8u %8u %8u %8u", i, stats.count, stats.total / stats.count,
+                        histogram_small_percentile(&stats.hist, 50),
+                        histogram_small_percentile(&stats.hist, 99), stats.hist.max);
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_decision_reset(const struct shell *sh, size_t argc, char **argv) {
+    decision_latency_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_decision,
+                               SHELL_CMD(show, NULL, "Show press to keycode latency",
+                                         cmd_decision_show),
+                               SHELL_CMD(reset, NULL, "Reset the recorded latencies",
+                                         cmd_decision_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), decision, &sub_decision, "Hold-tap and combo decision latency", NULL,
+                 1, 0);
+#endif
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/matrix.h>
+
+#include "histogram.h"
+
+// latencies of one position in milliseconds, the event timestamp resolution
+struct decision_latency_position {
+    uint16_t count;
+    uint32_t total;
+    struct histogram_small hist;
+};
+
+// copies the histogram over all positions, latencies in milliseconds as well
+void decision_latency_get_overall(struct histogram *hist);
+int decision_latency_get_position(uint32_t position, struct decision_latency_position *stats);
+// position with the highest average latency in milliseconds, -ENODATA if nothing was recorded
+int decision_latency_slowest_position(uint32_t *position, uint32_t *avg);
+void decision_latency_reset(void);
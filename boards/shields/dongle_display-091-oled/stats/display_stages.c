@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "bench.h"
+#include "frame_capture.h"
+#include "oled_power.h"
+#include "../hid_fb.h"
+
+static bool hooked;
+static lv_timer_cb_t refresh_cb;
+static void (*flush_cb)(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+
+DONGLE_BENCH_DEFINE(lvgl_refresh);
+DONGLE_BENCH_DEFINE(lvgl_flush);
+
+// rendering of all invalidated areas, including their flushes
+static void staged_refresh_cb(lv_timer_t *timer) {
+    DONGLE_BENCH_BEGIN(lvgl_refresh);
+    refresh_cb(timer);
+    DONGLE_BENCH_END(lvgl_refresh);
+}
+
+// with a flush thread configured in the LVGL module this only covers handing the area over
+static void staged_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_RAW_HID)
+    // first, so the recorders below see what actually reaches the panel
+    hid_fb_patch_flush(area, (uint8_t *)color_p);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_FRAME_CAPTURE)
+    // before the flush, which may hand the buffer back to LVGL
+    frame_capture_record(area, (const uint8_t *)color_p);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_POWER)
+    oled_power_record_flush(area, (const uint8_t *)color_p);
+#endif
+
+    DONGLE_BENCH_BEGIN(lvgl_flush);
+    flush_cb(drv, area, color_p);
+    DONGLE_BENCH_END(lvgl_flush);
+}
+
+void dongle_bench_hook_display(lv_disp_t *disp) {
+    if (disp == NULL || hooked) {
+        return;
+    }
+
+    hooked = true;
+
+    if (disp->refr_timer != NULL) {
+        refresh_cb = disp->refr_timer->timer_cb;
+        disp->refr_timer->timer_cb = staged_refresh_cb;
+    }
+
+    if (disp->driver != NULL) {
+        flush_cb = disp->driver->flush_cb;
+        disp->driver->flush_cb = staged_flush_cb;
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "frame_capture.h"
+
+#define FRAMES CONFIG_ZMK_DONGLE_DISPLAY_FRAME_CAPTURE_FRAMES
+#define STRIDE (FRAME_CAPTURE_WIDTH / 8)
+
+BUILD_ASSERT(FRAME_CAPTURE_WIDTH % 8 == 0, "Frame capture needs a width that is a multiple of 8");
+
+struct captured_frame {
+    uint32_t seq;
+    uint32_t timestamp;
+    lv_area_t dirty;
+    uint8_t pixels[FRAME_CAPTURE_SIZE];
+};
+
+static struct captured_frame frames[FRAMES];
+static uint32_t next_seq;
+
+// what the panel shows, updated with every flushed area
+static uint8_t panel[FRAME_CAPTURE_SIZE];
+
+static struct k_spinlock lock;
+
+static const struct device *display = DEVICE_DT_GET(DT_CHOSEN(zephyr_display));
+
+// the flushed buffer uses the layout the LVGL module packs mono pixels in for this display
+static bool get_flushed_pixel(const struct display_capabilities *caps, const uint8_t *buf,
+                              int w, int x, int y) {
+    bool msb_first = caps->screen_info & SCREEN_INFO_MONO_MSB_FIRST;
+
+    if (caps->screen_info & SCREEN_INFO_MONO_VTILED) {
+        return buf[x + y / 8 * w] & BIT(msb_first ? 7 - y % 8 : y % 8);
+    }
+
+    return buf[x / 8 + y * w / 8] & BIT(msb_first ? 7 - x % 8 : x % 8);
+}
+
+void frame_capture_record(const lv_area_t *area, const uint8_t *buf) {
+    struct display_capabilities caps;
+    int w = lv_area_get_width(area);
+
+    display_get_capabilities(display, &caps);
+
+    for (int y = MAX(area->y1, 0); y <= MIN(area->y2, FRAME_CAPTURE_HEIGHT - 1); y++) {
+        for (int x = MAX(area->x1, 0); x <= MIN(area->x2, FRAME_CAPTURE_WIDTH - 1); x++) {
+            uint8_t *byte = &panel[y * STRIDE + x / 8];
+
+            if (get_flushed_pixel(&caps, buf, w, x - area->x1, y - area->y1)) {
+                *byte |= BIT(7 - x % 8);
+            } else {
+                *byte &= ~BIT(7 - x % 8);
+            }
+        }
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    struct captured_frame *frame = &frames[next_seq % FRAMES];
+    frame->seq = next_seq++;
+    frame->timestamp = k_uptime_get_32();
+    frame->dirty = *area;
+    memcpy(frame->pixels, panel, sizeof(panel));
+    k_spin_unlock(&lock, key);
+}
+
+static int cmd_frames_dump(const struct shell *sh, size_t argc, char **argv) {
+    static struct captured_frame frame;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint32_t end = next_seq;
+    k_spin_unlock(&lock, key);
+
+    uint32_t start = end > FRAMES ? end - FRAMES : 0;
+
+    // parsed by scripts/frames_to_gif.py
+    shell_print(sh, "frames %u %d %d", end - start, FRAME_CAPTURE_WIDTH, FRAME_CAPTURE_HEIGHT);
+    for (uint32_t seq = start; seq < end; seq++) {
+        key = k_spin_lock(&lock);
+        frame = frames[seq % FRAMES];
+        k_spin_unlock(&lock, key);
+
+        // overwritten by a newer flush while dumping
+        if (frame.seq != seq) {
+            continue;
+        }
+
+        shell_print(sh, "frame %u %u %d %d %d %d", frame.seq, frame.timestamp, frame.dirty.x1,
+                    frame.dirty.y1, frame.dirty.x2, frame.dirty.y2);
+        for (int row = 0; row < FRAME_CAPTURE_SIZE; row += 32) {
+            char hex[2 * 32 + 1];
+            bin2hex(&frame.pixels[row], MIN(32, FRAME_CAPTURE_SIZE - row), hex, sizeof(hex));
+            shell_print(sh, "%s", hex);
+        }
+    }
+    shell_print(sh, "end");
+
+    return 0;
+}
+
+static int cmd_frames_clear(const struct shell *sh, size_t argc, char **argv) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    next_seq = 0;
+    memset(frames, 0, sizeof(frames));
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_frames,
+                               SHELL_CMD(dump, NULL, "Print the captured frames", cmd_frames_dump),
+                               SHELL_CMD(clear, NULL, "Drop the captured frames", cmd_frames_clear),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), frames, &sub_frames, "Frames flushed to the panel", NULL, 1, 0);
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+
+#define FRAME_CAPTURE_WIDTH DT_PROP(DT_CHOSEN(zephyr_display), width)
+#define FRAME_CAPTURE_HEIGHT DT_PROP(DT_CHOSEN(zephyr_display), height)
+// rows of width / 8 bytes, MSB first, a set bit is a set bit in the panel memory
+#define FRAME_CAPTURE_SIZE (FRAME_CAPTURE_WIDTH * FRAME_CAPTURE_HEIGHT / 8)
+
+// Copies the area LVGL is about to flush into the panel image and keeps the result in the ring.
+void frame_capture_record(const lv_area_t *area, const uint8_t *buf);
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/keys.h>
+
+#include "hid_rate.h"
+
+#define WINDOW CONFIG_ZMK_DONGLE_DISPLAY_HID_RATE_WINDOW_SECONDS
+
+struct rate_counter {
+    uint16_t current;
+    uint16_t last;
+    uint16_t peak;
+    uint16_t window[WINDOW];
+};
+
+static struct rate_counter keycodes;
+static struct rate_counter modifiers;
+static int64_t current_second;
+static uint8_t window_head;
+
+static struct k_spinlock lock;
+
+static void counter_roll(struct rate_counter *counter, int64_t elapsed) {
+    // seconds without any event count as zero
+    for (int64_t i = 0; i < MIN(elapsed, WINDOW); i++) {
+        uint8_t slot = (window_head + i) % WINDOW;
+        counter->window[slot] = (i == 0 && elapsed <= WINDOW) ? counter->current : 0;
+    }
+
+    counter->last = elapsed == 1 ? counter->current : 0;
+    counter->current = 0;
+
+    counter->peak = 0;
+    for (int i = 0; i < WINDOW; i++) {
+        counter->peak = MAX(counter->peak, counter->window[i]);
+    }
+}
+
+// constant time: the window scan only happens once per elapsed second
+static void roll(int64_t now_second) {
+    int64_t elapsed = now_second - current_second;
+    if (elapsed <= 0) {
+        return;
+    }
+
+    counter_roll(&keycodes, elapsed);
+    counter_roll(&modifiers, elapsed);
+    window_head = (window_head + MIN(elapsed, WINDOW)) % WINDOW;
+    current_second = now_second;
+}
+
+static int hid_rate_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    roll(k_uptime_get() / MSEC_PER_SEC);
+    keycodes.current = MIN(keycodes.current + 1, UINT16_MAX);
+    if (is_mod(ev->usage_page, ev->keycode)) {
+        modifiers.current = MIN(modifiers.current + 1, UINT16_MAX);
+    }
+    k_spin_unlock(&lock, key);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_hid_rate, hid_rate_listener);
+ZMK_SUBSCRIPTION(dongle_hid_rate, zmk_keycode_state_changed);
+
+void hid_rate_get(struct hid_rate *rate) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    roll(k_uptime_get() / MSEC_PER_SEC);
+    *rate = (struct hid_rate){
+        .keycodes = keycodes.last,
+        .modifiers = modifiers.last,
+        .keycodes_peak = keycodes.peak,
+        .modifiers_peak = modifiers.peak,
+    };
+    k_spin_unlock(&lock, key);
+}
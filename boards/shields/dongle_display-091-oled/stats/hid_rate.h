@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct hid_rate {
+    // events in the last complete second
+    uint16_t keycodes;
+    uint16_t modifiers;
+    // highest one second count within the sliding window
+    uint16_t keycodes_peak;
+    uint16_t modifiers_peak;
+};
+
+void hid_rate_get(struct hid_rate *rate);
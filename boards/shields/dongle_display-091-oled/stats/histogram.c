@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "histogram.h"
+
+static uint8_t bucket_index(uint32_t value, uint8_t len) {
+    if (value < 4) {
+        return value;
+    }
+
+    uint8_t msb = 31 - __builtin_clz(value);
+    uint8_t index = (msb - 1) * 4 + ((value >> (msb - 2)) & 3);
+
+    return MIN(index, len - 1);
+}
+
+static uint32_t bucket_upper_bound(uint8_t index) {
+    if (index < 4) {
+        return index;
+    }
+
+    uint8_t shift = index / 4 - 1;
+    uint32_t lower = (4 + index % 4) << shift;
+
+    return lower + BIT(shift) - 1;
+}
+
+// shared by both sizes, which only differ in the number of buckets
+static void buckets_record(uint32_t *count, uint32_t *max, uint16_t *buckets, uint8_t len,
+                           uint32_t value) {
+    uint8_t index = bucket_index(value, len);
+
+    // halve every bucket instead of wrapping, older samples fade out but the shape is kept
+    if (buckets[index] == UINT16_MAX) {
+        *count = 0;
+        for (int i = 0; i < len; i++) {
+            buckets[i] /= 2;
+            *count += buckets[i];
+        }
+    }
+
+    buckets[index]++;
+    (*count)++;
+    if (value > *max) {
+        *max = value;
+    }
+}
+
+static uint32_t buckets_percentile(uint32_t count, uint32_t max, const uint16_t *buckets,
+                                   uint8_t len, uint8_t percentile) {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint32_t target = DIV_ROUND_UP((uint64_t)count * percentile, 100);
+    uint32_t seen = 0;
+    int i;
+
+    for (i = 0; i < len; i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            break;
+        }
+    }
+
+    // the last bucket also holds everything above its range
+    return i < len - 1 ? MIN(bucket_upper_bound(i), max) : max;
+}
+
+void histogram_record(struct histogram *hist, uint32_t value) {
+    buckets_record(&hist->count, &hist->max, hist->buckets, HISTOGRAM_BUCKETS, value);
+}
+
+uint32_t histogram_percentile(const struct histogram *hist, uint8_t percentile) {
+    return buckets_percentile(hist->count, hist->max, hist->buckets, HISTOGRAM_BUCKETS, percentile);
+}
+
+void histogram_reset(struct histogram *hist) { memset(hist, 0, sizeof(*hist)); }
+
+void histogram_small_record(struct histogram_small *hist, uint32_t value) {
+    buckets_record(&hist->count, &hist->max, hist->buckets, HISTOGRAM_SMALL_BUCKETS, value);
+}
+
+uint32_t histogram_small_percentile(const struct histogram_small *hist, uint8_t percentile) {
+    return buckets_percentile(hist->count, hist->max, hist->buckets, HISTOGRAM_SMALL_BUCKETS,
+                              percentile);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+// Log-linear buckets: four sub-buckets per power of two, exact below 4, covering up to 2^25 - 1.
+#define HISTOGRAM_BUCKETS 96
+
+struct histogram {
+    uint32_t count;
+    uint32_t max;
+    uint16_t buckets[HISTOGRAM_BUCKETS];
+};
+
+// The first buckets of the same layout, for per key tables, covering up to 2^9 - 1. Larger values
+// land in the last bucket and are only kept exactly in max.
+#define HISTOGRAM_SMALL_BUCKETS 32
+
+struct histogram_small {
+    uint32_t count;
+    uint32_t max;
+    uint16_t buckets[HISTOGRAM_SMALL_BUCKETS];
+};
+
+void histogram_record(struct histogram *hist, uint32_t value);
+// Upper bound of the bucket holding the given percentile, 0 if nothing was recorded.
+uint32_t histogram_percentile(const struct histogram *hist, uint8_t percentile);
+void histogram_reset(struct histogram *hist);
+
+void histogram_small_record(struct histogram_small *hist, uint32_t value);
+uint32_t histogram_small_percentile(const struct histogram_small *hist, uint8_t percentile);
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "host_time.h"
+
+// set by the raw HID handler and read by the widgets, all on the display work queue
+static bool synced;
+static int64_t base_unix_ms;
+static int64_t base_uptime_ms;
+static int32_t offset_ms;
+static struct host_time_drift drift;
+
+void host_time_set(int64_t unix_ms, int16_t utc_offset) {
+    int64_t now = k_uptime_get();
+
+    if (synced) {
+        int64_t elapsed = now - base_uptime_ms;
+        int64_t error = unix_ms - (base_unix_ms + elapsed);
+
+        drift.offset_ms = CLAMP(error, INT32_MIN, INT32_MAX);
+        drift.ppm = elapsed > 0 ? CLAMP(error * 1000000 / elapsed, INT32_MIN, INT32_MAX) : 0;
+        LOG_DBG("Host time sync after %u s, off by %d ms (%d ppm)",
+                (uint32_t)(elapsed / MSEC_PER_SEC), drift.offset_ms, drift.ppm);
+    }
+
+    synced = true;
+    base_unix_ms = unix_ms;
+    base_uptime_ms = now;
+    offset_ms = utc_offset * 60 * MSEC_PER_SEC;
+    drift.syncs++;
+}
+
+bool host_time_now(int64_t *local_ms) {
+    if (!synced) {
+        return false;
+    }
+
+    *local_ms = base_unix_ms + (k_uptime_get() - base_uptime_ms) + offset_ms;
+    return true;
+}
+
+void host_time_get_drift(struct host_time_drift *out) {
+    *out = drift;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct host_time_drift {
+    uint32_t syncs;
+    // host time minus the time the dongle kept since the previous sync, at the latest sync
+    int32_t offset_ms;
+    // the same offset per million milliseconds since the previous sync, positive if slow
+    int32_t ppm;
+};
+
+// Sets the wall clock from the host; unix_ms is UTC, utc_offset the local zone in minutes.
+// The dongle keeps time with its uptime counter until the next sync.
+void host_time_set(int64_t unix_ms, int16_t utc_offset);
+
+// local wall time in milliseconds since the epoch, false until the host sent the time once
+bool host_time_now(int64_t *local_ms);
+
+void host_time_get_drift(struct host_time_drift *drift);
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/keymap.h>
+#include <zmk/matrix.h>
+
+#include "key_stats.h"
+
+#define SETTINGS_NAME "dongle"
+#define SETTINGS_KEY "keystats"
+#define FLUSH_INTERVAL_MS                                                                          \
+    ((int64_t)CONFIG_ZMK_DONGLE_DISPLAY_KEY_STATS_FLUSH_MINUTES * 60 * MSEC_PER_SEC)
+
+// stored as one blob, a keymap with a different size discards the stored counters
+struct key_stats_counters {
+    uint32_t positions[ZMK_KEYMAP_LEN];
+    uint32_t layers[ZMK_KEYMAP_LAYERS_LEN];
+};
+
+// the counters, dirty and last_flush are shared by the listener, the flush work and the shell
+static struct key_stats_counters counters;
+static uint32_t total;
+static bool dirty;
+static struct k_spinlock lock;
+
+static uint32_t flushes;
+static int64_t last_flush;
+
+static void flush_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_cb);
+
+static void flush_work_cb(struct k_work *work) {
+    struct key_stats_counters snapshot;
+
+    // cleared together with the copy so presses during the write mark the counters dirty again,
+    // and last_flush is taken before the write so they schedule the next one a full interval later
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    if (!dirty) {
+        k_spin_unlock(&lock, key);
+        return;
+    }
+    dirty = false;
+    snapshot = counters;
+    last_flush = k_uptime_get();
+    k_spin_unlock(&lock, key);
+
+    int err = settings_save_one(SETTINGS_NAME "/" SETTINGS_KEY, &snapshot, sizeof(snapshot));
+    if (err) {
+        LOG_ERR("Failed to save key statistics (err %d)", err);
+        key = k_spin_lock(&lock);
+        dirty = true;
+        k_spin_unlock(&lock, key);
+        // presses only schedule a flush when the counters were clean, so nothing else would retry
+        k_work_schedule(&flush_work, K_MSEC(FLUSH_INTERVAL_MS));
+        return;
+    }
+
+    flushes++;
+}
+
+// writes at most once per flush interval, whether triggered by time or by idle
+static void schedule_flush(bool idle) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    int64_t earliest = last_flush + FLUSH_INTERVAL_MS;
+
+    if (flushes == 0 && idle) {
+        earliest = 0;
+    }
+    k_spin_unlock(&lock, key);
+
+    int64_t delay = MAX(earliest - k_uptime_get(), 0);
+
+    // a press keeps a flush that is already scheduled, but unlike a pending check it still
+    // schedules one while the previous write is running
+    if (idle) {
+        k_work_reschedule(&flush_work, K_MSEC(delay));
+    } else {
+        k_work_schedule(&flush_work, K_MSEC(delay));
+    }
+}
+
+static int key_stats_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *pos_ev = as_zmk_position_state_changed(eh);
+    if (pos_ev != NULL) {
+        if (pos_ev->state && pos_ev->position < ZMK_KEYMAP_LEN) {
+            uint8_t layer = zmk_keymap_highest_layer_active();
+
+            k_spinlock_key_t key = k_spin_lock(&lock);
+            counters.positions[pos_ev->position]++;
+            counters.layers[layer]++;
+            total++;
+            bool was_dirty = dirty;
+            dirty = true;
+            k_spin_unlock(&lock, key);
+
+            if (!was_dirty) {
+                schedule_flush(false);
+            }
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_activity_state_changed *activity_ev = as_zmk_activity_state_changed(eh);
+    if (activity_ev != NULL && activity_ev->state != ZMK_ACTIVITY_ACTIVE) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        bool was_dirty = dirty;
+        k_spin_unlock(&lock, key);
+
+        if (was_dirty) {
+            schedule_flush(true);
+        }
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_key_stats, key_stats_listener);
+ZMK_SUBSCRIPTION(dongle_key_stats, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(dongle_key_stats, zmk_activity_state_changed);
+
+static int key_stats_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                  void *cb_arg) {
+    const char *next;
+
+    if (!settings_name_steq(name, SETTINGS_KEY, &next) || next) {
+        return -ENOENT;
+    }
+
+    if (len != sizeof(counters)) {
+        LOG_WRN("Discarding key statistics stored for a different keymap");
+        return 0;
+    }
+
+    struct key_stats_counters stored;
+    int err = read_cb(cb_arg, &stored, sizeof(stored));
+    if (err < 0) {
+        return err;
+    }
+
+    // presses counted before the settings were loaded are added on top
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    total = 0;
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        counters.positions[i] += stored.positions[i];
+        total += counters.positions[i];
+    }
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        counters.layers[i] += stored.layers[i];
+    }
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(dongle_key_stats, SETTINGS_NAME, NULL, key_stats_settings_set, NULL,
+                               NULL);
+
+void key_stats_get_summary(struct key_stats_summary *summary) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *summary = (struct key_stats_summary){
+        .total = total,
+        .flushes = flushes,
+        .last_flush = last_flush,
+        .dirty = dirty,
+    };
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        if (counters.layers[i] > summary->top_layer_presses) {
+            summary->top_layer = i;
+            summary->top_layer_presses = counters.layers[i];
+        }
+    }
+    k_spin_unlock(&lock, key);
+}
+
+uint32_t key_stats_get_position(uint32_t position) {
+    uint32_t count = 0;
+
+    if (position < ZMK_KEYMAP_LEN) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        count = counters.positions[position];
+        k_spin_unlock(&lock, key);
+    }
+
+    return count;
+}
+
+uint32_t key_stats_get_layer(uint8_t layer) {
+    uint32_t count = 0;
+
+    if (layer < ZMK_KEYMAP_LAYERS_LEN) {
+        k_spinlock_key_t key = k_spin_lock(&lock);
+        count = counters.layers[layer];
+        k_spin_unlock(&lock, key);
+    }
+
+    return count;
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_keystats_show(const struct shell *sh, size_t argc, char **argv) {
+    struct key_stats_summary summary;
+    key_stats_get_summary(&summary);
+
+    shell_print(sh, "total presses: %u", summary.total);
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        uint32_t count = key_stats_get_layer(i);
+        if (count > 0) {
+            shell_print(sh, "layer %d: %u", i, count);
+        }
+    }
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        uint32_t count = key_stats_get_position(i);
+        if (count > 0) {
+            shell_print(sh, "position %d: %u", i, count);
+        }
+    }
+
+    // 32 bits, so it also prints with CONFIG_CBPRINTF_REDUCED_INTEGRAL
+    int32_t ago_s = summary.flushes
+                        ? (int32_t)((k_uptime_get() - summary.last_flush) / MSEC_PER_SEC)
+                        : -1;
+    shell_print(sh, "flash writes: %u of %u bytes, last %d s ago, %s", summary.flushes,
+                (uint32_t)sizeof(counters), ago_s, summary.dirty ? "unsaved changes" : "saved");
+
+    return 0;
+}
+
+static int cmd_keystats_flush(const struct shell *sh, size_t argc, char **argv) {
+    k_work_reschedule(&flush_work, K_NO_WAIT);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_keystats,
+                               SHELL_CMD(show, NULL, "Show press counters and flash writes",
+                                         cmd_keystats_show),
+                               SHELL_CMD(flush, NULL, "Write the counters to flash now",
+                                         cmd_keystats_flush),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), keystats, &sub_keystats, "Persistent keystroke statistics", NULL, 1,
+                 0);
+#endif
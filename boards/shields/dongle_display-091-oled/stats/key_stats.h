@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct key_stats_summary {
+    uint32_t total;
+    uint8_t top_layer;
+    uint32_t top_layer_presses;
+    // flash writes since boot and uptime of the last one in milliseconds
+    uint32_t flushes;
+    int64_t last_flush;
+    // presses not written to flash yet
+    bool dirty;
+};
+
+void key_stats_get_summary(struct key_stats_summary *summary);
+uint32_t key_stats_get_position(uint32_t position);
+uint32_t key_stats_get_layer(uint8_t layer);
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "link_health.h"
+#include "../split_conn.h"
+
+static struct link_health_stats slots[LINK_HEALTH_SLOTS];
+// a reference per connected slot, for the RSSI reads
+static struct bt_conn *conns[LINK_HEALTH_SLOTS];
+
+K_MUTEX_DEFINE(link_health_lock);
+
+// Reading the RSSI blocks until the controller answers, which never happens on the system work
+// queue when the HCI receive path runs there too, so the sampler gets a queue of its own.
+static K_THREAD_STACK_DEFINE(rssi_sample_stack,
+                             CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_RSSI_STACK_SIZE);
+static struct k_work_q rssi_sample_work_q;
+
+static void rssi_sample_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(rssi_sample_work, rssi_sample_work_cb);
+
+static int find_slot(const bt_addr_le_t *addr, bool allocate) {
+    return link_health_find_slot(slots, LINK_HEALTH_SLOTS, (const uint8_t *)addr, allocate);
+}
+
+static void link_health_connected(struct bt_conn *conn, uint8_t err) {
+    struct bt_conn_info info;
+
+    if (err || !is_split_conn(conn, &info)) {
+        return;
+    }
+
+    k_mutex_lock(&link_health_lock, K_FOREVER);
+
+    int slot = find_slot(info.le.dst, true);
+    if (slot < 0) {
+        LOG_WRN("No link health slot left for split connection");
+        k_mutex_unlock(&link_health_lock);
+        return;
+    }
+
+    if (conns[slot] != NULL) {
+        bt_conn_unref(conns[slot]);
+    }
+    conns[slot] = bt_conn_ref(conn);
+    link_health_on_connected(&slots[slot], info.le.interval, info.le.latency, info.le.timeout);
+
+    k_mutex_unlock(&link_health_lock);
+
+    k_work_schedule_for_queue(&rssi_sample_work_q, &rssi_sample_work, K_NO_WAIT);
+}
+
+static void link_health_disconnected(struct bt_conn *conn, uint8_t reason) {
+    struct bt_conn_info info;
+
+    if (!is_split_conn(conn, &info)) {
+        return;
+    }
+
+    k_mutex_lock(&link_health_lock, K_FOREVER);
+
+    int slot = find_slot(info.le.dst, false);
+    if (slot >= 0) {
+        if (conns[slot] != NULL) {
+            bt_conn_unref(conns[slot]);
+            conns[slot] = NULL;
+        }
+        link_health_on_disconnected(&slots[slot], reason);
+    }
+
+    k_mutex_unlock(&link_health_lock);
+}
+
+static void link_health_le_param_updated(struct bt_conn *conn, uint16_t interval, uint16_t latency,
+                                         uint16_t timeout) {
+    struct bt_conn_info info;
+
+    if (!is_split_conn(conn, &info)) {
+        return;
+    }
+
+    k_mutex_lock(&link_health_lock, K_FOREVER);
+
+    int slot = find_slot(info.le.dst, false);
+    if (slot >= 0) {
+        link_health_on_param_updated(&slots[slot], interval, latency, timeout);
+    }
+
+    k_mutex_unlock(&link_health_lock);
+}
+
+BT_CONN_CB_DEFINE(link_health_conn_callbacks) = {
+    .connected = link_health_connected,
+    .disconnected = link_health_disconnected,
+    .le_param_updated = link_health_le_param_updated,
+};
+
+static int read_rssi(struct bt_conn *conn, int8_t *rssi) {
+    struct net_buf *buf, *rsp = NULL;
+    struct bt_hci_cp_read_rssi *cp;
+    struct bt_hci_rp_read_rssi *rp;
+    uint16_t handle;
+    int err;
+
+    err = bt_hci_get_conn_handle(conn, &handle);
+    if (err) {
+        return err;
+    }
+
+    buf = bt_hci_cmd_create(BT_HCI_OP_READ_RSSI, sizeof(*cp));
+    if (buf == NULL) {
+        return -ENOBUFS;
+    }
+
+    cp = net_buf_add(buf, sizeof(*cp));
+    cp->handle = sys_cpu_to_le16(handle);
+
+    err = bt_hci_cmd_send_sync(BT_HCI_OP_READ_RSSI, buf, &rsp);
+    if (err) {
+        return err;
+    }
+
+    rp = (void *)rsp->data;
+    err = rp->status ? -EIO : 0;
+    *rssi = rp->rssi;
+    net_buf_unref(rsp);
+
+    return err;
+}
+
+static void rssi_sample_work_cb(struct k_work *work) {
+    bool any_connected = false;
+
+    for (int i = 0; i < LINK_HEALTH_SLOTS; i++) {
+        struct bt_conn *conn = NULL;
+
+        k_mutex_lock(&link_health_lock, K_FOREVER);
+        if (conns[i] != NULL) {
+            conn = bt_conn_ref(conns[i]);
+        }
+        k_mutex_unlock(&link_health_lock);
+
+        if (conn == NULL) {
+            continue;
+        }
+
+        any_connected = true;
+
+        int8_t rssi;
+        int err = read_rssi(conn, &rssi);
+        bt_conn_unref(conn);
+
+        if (err) {
+            LOG_DBG("Failed to read RSSI of split link %d (err %d)", i, err);
+            continue;
+        }
+
+        k_mutex_lock(&link_health_lock, K_FOREVER);
+        link_health_add_rssi(&slots[i], rssi);
+        k_mutex_unlock(&link_health_lock);
+    }
+
+    if (any_connected) {
+        k_work_schedule_for_queue(&rssi_sample_work_q, &rssi_sample_work,
+                                  K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_RSSI_INTERVAL_MS));
+    }
+}
+
+// started before ZMK enables Bluetooth, so no connection can schedule onto it earlier
+static int link_health_init(void) {
+    const struct k_work_queue_config config = {.name = "link_health_rssi"};
+
+    k_work_queue_start(&rssi_sample_work_q, rssi_sample_stack,
+                       K_THREAD_STACK_SIZEOF(rssi_sample_stack), K_LOWEST_APPLICATION_THREAD_PRIO,
+                       &config);
+    return 0;
+}
+
+SYS_INIT(link_health_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+int link_health_get(uint8_t slot, struct link_health_stats *stats) {
+    if (slot >= LINK_HEALTH_SLOTS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&link_health_lock, K_FOREVER);
+    *stats = slots[slot];
+    k_mutex_unlock(&link_health_lock);
+
+    return 0;
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_link(const struct shell *sh, size_t argc, char **argv) {
+    for (int i = 0; i < LINK_HEALTH_SLOTS; i++) {
+        struct link_health_stats stats;
+        char addr[BT_ADDR_LE_STR_LEN];
+
+        link_health_get(i, &stats);
+        if (!stats.in_use) {
+            shell_print(sh, "peripheral %d: never connected", i);
+            continue;
+        }
+
+        bt_addr_le_to_str((const bt_addr_le_t *)stats.addr, addr, sizeof(addr));
+        shell_print(sh, "peripheral %d: %s %s", i, addr,
+                    stats.connected ? "connected" : "disconnected");
+        shell_print(sh, "  interval %u.%02u ms, latency %u, timeout %u ms", stats.interval * 5 / 4,
+                    (stats.interval * 125) % 100, stats.latency, stats.timeout * 10);
+        shell_print(sh, "  rssi last %d dBm, avg %d dBm over %u samples",
+                    link_health_rssi_last(&stats), link_health_rssi_avg(&stats),
+                    stats.rssi_count);
+        shell_print(sh, "  connects %u, param updates %u, disconnects %u (last reason 0x%02x)",
+                    stats.connects, stats.param_updates, stats.disconnects,
+                    stats.last_disconnect_reason);
+    }
+
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((dongle), link, NULL, "Show BLE link health of the split peripherals", cmd_link,
+                 1, 0);
+#endif
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/addr.h>
+#include <zmk/ble.h>
+
+#include "link_health_state.h"
+
+#define LINK_HEALTH_SLOTS ZMK_SPLIT_BLE_PERIPHERAL_COUNT
+
+BUILD_ASSERT(sizeof(bt_addr_le_t) == LINK_HEALTH_ADDR_LEN);
+
+// Slots are assigned to peripherals in the order they first connect.
+int link_health_get(uint8_t slot, struct link_health_stats *stats);
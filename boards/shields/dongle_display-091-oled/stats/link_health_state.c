@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "link_health_state.h"
+
+int link_health_find_slot(struct link_health_stats *slots, size_t count, const uint8_t *addr,
+                          bool allocate) {
+    int free_slot = -ENOMEM;
+
+    for (size_t i = 0; i < count; i++) {
+        if (slots[i].in_use) {
+            if (memcmp(slots[i].addr, addr, LINK_HEALTH_ADDR_LEN) == 0) {
+                return i;
+            }
+        } else if (free_slot < 0) {
+            free_slot = i;
+        }
+    }
+
+    if (!allocate) {
+        return -ENOENT;
+    }
+
+    if (free_slot >= 0) {
+        slots[free_slot].in_use = true;
+        memcpy(slots[free_slot].addr, addr, LINK_HEALTH_ADDR_LEN);
+    }
+
+    return free_slot;
+}
+
+void link_health_on_connected(struct link_health_stats *stats, uint16_t interval,
+                              uint16_t latency, uint16_t timeout) {
+    stats->connected = true;
+    stats->connects++;
+    stats->interval = interval;
+    stats->latency = latency;
+    stats->timeout = timeout;
+}
+
+void link_health_on_disconnected(struct link_health_stats *stats, uint8_t reason) {
+    stats->connected = false;
+    stats->disconnects++;
+    stats->last_disconnect_reason = reason;
+}
+
+void link_health_on_param_updated(struct link_health_stats *stats, uint16_t interval,
+                                  uint16_t latency, uint16_t timeout) {
+    stats->interval = interval;
+    stats->latency = latency;
+    stats->timeout = timeout;
+    stats->param_updates++;
+}
+
+void link_health_add_rssi(struct link_health_stats *stats, int8_t rssi) {
+    stats->rssi[stats->rssi_head] = rssi;
+    stats->rssi_head = (stats->rssi_head + 1) % LINK_HEALTH_RSSI_SAMPLES;
+    if (stats->rssi_count < LINK_HEALTH_RSSI_SAMPLES) {
+        stats->rssi_count++;
+    }
+}
+
+int8_t link_health_rssi_last(const struct link_health_stats *stats) {
+    if (stats->rssi_count == 0) {
+        return LINK_HEALTH_RSSI_UNKNOWN;
+    }
+
+    return stats->rssi[(stats->rssi_head + LINK_HEALTH_RSSI_SAMPLES - 1) % LINK_HEALTH_RSSI_SAMPLES];
+}
+
+// the ring fills from index 0, so the first rssi_count samples are always the valid ones
+int8_t link_health_rssi_avg(const struct link_health_stats *stats) {
+    if (stats->rssi_count == 0) {
+        return LINK_HEALTH_RSSI_UNKNOWN;
+    }
+
+    int sum = 0;
+    for (int i = 0; i < stats->rssi_count; i++) {
+        sum += stats->rssi[i];
+    }
+
+    return sum / stats->rssi_count;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+// The per peripheral bookkeeping of link_health.c, free of Zephyr so scripts/tests can run it on
+// the host. The Bluetooth callbacks and the RSSI reads stay in link_health.c.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LINK_HEALTH_RSSI_SAMPLES CONFIG_ZMK_DONGLE_DISPLAY_LINK_HEALTH_RSSI_SAMPLES
+// below anything a controller reports (-127 dBm at the lowest), never a sample itself
+#define LINK_HEALTH_RSSI_UNKNOWN INT8_MIN
+// the bytes of a bt_addr_le_t, type first
+#define LINK_HEALTH_ADDR_LEN 7
+
+struct link_health_stats {
+    bool in_use;
+    bool connected;
+    uint8_t addr[LINK_HEALTH_ADDR_LEN];
+    // connection parameters in the units used by the controller
+    uint16_t interval;   // 1.25 ms
+    uint16_t latency;    // connection events
+    uint16_t timeout;    // 10 ms
+    int8_t rssi[LINK_HEALTH_RSSI_SAMPLES];
+    uint8_t rssi_head;
+    uint8_t rssi_count;
+    uint32_t connects;
+    uint32_t param_updates;
+    uint32_t disconnects;
+    uint8_t last_disconnect_reason;
+};
+
+// Returns the slot of addr, or with allocate the first free slot, which is then taken for addr.
+// Returns -ENOENT, or -ENOMEM when every slot belongs to another peripheral.
+int link_health_find_slot(struct link_health_stats *slots, size_t count, const uint8_t *addr,
+                          bool allocate);
+
+void link_health_on_connected(struct link_health_stats *stats, uint16_t interval,
+                              uint16_t latency, uint16_t timeout);
+void link_health_on_disconnected(struct link_health_stats *stats, uint8_t reason);
+void link_health_on_param_updated(struct link_health_stats *stats, uint16_t interval,
+                                  uint16_t latency, uint16_t timeout);
+void link_health_add_rssi(struct link_health_stats *stats, int8_t rssi);
+
+int8_t link_health_rssi_last(const struct link_health_stats *stats);
+int8_t link_health_rssi_avg(const struct link_health_stats *stats);
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "oled_power.h"
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_LIGHT_CAT)
+#include "../widgets/bongo_cat.h"
+#endif
+
+#define DISPLAY_NODE DT_CHOSEN(zephyr_display)
+#define PANEL_WIDTH DT_PROP(DISPLAY_NODE, width)
+#define PANEL_PAGES (DT_PROP(DISPLAY_NODE, height) / 8)
+// an inverted panel lights the pixels whose bit is clear
+#define PANEL_INVERTED DT_PROP_OR(DISPLAY_NODE, inversion_on, 0)
+
+#define BUDGET CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_PIXELS
+#define BUDGET_WINDOW CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_WINDOW_MINUTES
+// the average is kept in 1/256 pixels so small steps are not lost
+#define AVG_SHIFT 8
+
+static const struct device *display = DEVICE_DT_GET(DISPLAY_NODE);
+
+// the panel memory as the flushes left it, one byte per 8 vertical pixels
+static uint8_t panel[PANEL_PAGES][PANEL_WIDTH];
+static uint32_t panel_set_bits;
+
+static bool panel_on = true;
+static int64_t last_change;
+static uint64_t lit_pixel_ms;
+static uint64_t window_start_pixel_ms;
+static uint32_t avg_lit_fixed;
+static bool over_budget;
+static uint32_t budget_trips;
+
+static struct k_spinlock lock;
+
+static uint32_t lit_pixels(void) {
+    if (!panel_on) {
+        return 0;
+    }
+
+    return PANEL_INVERTED ? PANEL_PAGES * PANEL_WIDTH * 8 - panel_set_bits : panel_set_bits;
+}
+
+// the current lit count is accounted up to now before it changes
+static void integrate(int64_t now) {
+    lit_pixel_ms += (uint64_t)lit_pixels() * (now - last_change);
+    last_change = now;
+}
+
+void oled_power_record_flush(const lv_area_t *area, const uint8_t *buf) {
+    struct display_capabilities caps;
+    display_get_capabilities(display, &caps);
+
+    // vertically tiled panels get whole pages flushed, which map to panel memory byte for byte
+    if (!(caps.screen_info & SCREEN_INFO_MONO_VTILED) || area->y1 % 8 != 0) {
+        LOG_WRN_ONCE("Lit pixel counting needs a vertically tiled mono panel");
+        return;
+    }
+
+    int w = lv_area_get_width(area);
+    int pages = DIV_ROUND_UP(lv_area_get_height(area), 8);
+    int32_t delta = 0;
+
+    for (int p = 0; p < pages && area->y1 / 8 + p < PANEL_PAGES; p++) {
+        uint8_t *row = panel[area->y1 / 8 + p];
+
+        for (int x = 0; x < w && area->x1 + x < PANEL_WIDTH; x++) {
+            uint8_t byte = buf[p * w + x];
+
+            delta += __builtin_popcount(byte) - __builtin_popcount(row[area->x1 + x]);
+            row[area->x1 + x] = byte;
+        }
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    integrate(k_uptime_get());
+    panel_set_bits += delta;
+    k_spin_unlock(&lock, key);
+}
+
+void oled_power_set_panel_on(bool on) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    integrate(k_uptime_get());
+    panel_on = on;
+    k_spin_unlock(&lock, key);
+}
+
+void oled_power_get_stats(struct oled_power_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    integrate(k_uptime_get());
+    stats->lit = lit_pixels();
+    stats->avg_lit = avg_lit_fixed >> AVG_SHIFT;
+    stats->lit_pixel_ms = lit_pixel_ms;
+    stats->over_budget = over_budget;
+    stats->budget_trips = budget_trips;
+    k_spin_unlock(&lock, key);
+
+    // nA per pixel times pixel milliseconds, to uAh
+    uint64_t charge_uah =
+        stats->lit_pixel_ms * CONFIG_ZMK_DONGLE_DISPLAY_OLED_NA_PER_PIXEL / 3600000000ULL;
+    stats->charge_uah = charge_uah;
+    stats->energy_uwh = charge_uah * CONFIG_ZMK_DONGLE_DISPLAY_OLED_SUPPLY_MV / 1000;
+}
+
+#if BUDGET > 0
+static void apply_budget_work_cb(struct k_work *work) {
+    bool exceeded = over_budget;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_DIM)
+    display_set_contrast(display, exceeded ? CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_DIM_CONTRAST
+                                           : CONFIG_ZMK_DONGLE_DISPLAY_OLED_CONTRAST);
+#elif IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_LIGHT_CAT)
+    zmk_widget_bongo_cat_set_light(exceeded);
+#endif
+}
+
+static K_WORK_DEFINE(apply_budget_work, apply_budget_work_cb);
+
+static void budget_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(budget_work, budget_work_cb);
+
+// once a minute the average of the last minute moves the window average by 1/window of the
+// difference; the budget is left again at 90 % so it does not flap at the limit
+static void budget_work_cb(struct k_work *work) {
+    bool changed = false;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    integrate(k_uptime_get());
+
+    uint32_t minute_avg_fixed = ((lit_pixel_ms - window_start_pixel_ms) << AVG_SHIFT) / 60000;
+    window_start_pixel_ms = lit_pixel_ms;
+    avg_lit_fixed = avg_lit_fixed + ((int32_t)(minute_avg_fixed - avg_lit_fixed)) / BUDGET_WINDOW;
+
+    uint32_t avg = avg_lit_fixed >> AVG_SHIFT;
+    if (!over_budget && avg > BUDGET) {
+        over_budget = true;
+        budget_trips++;
+        changed = true;
+    } else if (over_budget && avg < BUDGET * 9 / 10) {
+        over_budget = false;
+        changed = true;
+    }
+    k_spin_unlock(&lock, key);
+
+    if (changed) {
+        k_work_submit_to_queue(zmk_display_work_q(), &apply_budget_work);
+    }
+
+    k_work_schedule(&budget_work, K_MINUTES(1));
+}
+
+static int oled_power_init(void) {
+    k_work_schedule(&budget_work, K_MINUTES(1));
+    return 0;
+}
+
+SYS_INIT(oled_power_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+#endif
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_power(const struct shell *sh, size_t argc, char **argv) {
+    struct oled_power_stats stats;
+    oled_power_get_stats(&stats);
+
+    shell_print(sh, "lit now %u px, window avg %u px%s", stats.lit, stats.avg_lit,
+                stats.over_budget ? " (over budget)" : "");
+    // in minutes to fit 32 bits for CONFIG_CBPRINTF_REDUCED_INTEGRAL, about two years of a full panel
+    shell_print(sh, "since boot %u px*min, est. %u uAh, %u uWh",
+                (uint32_t)(stats.lit_pixel_ms / (60 * MSEC_PER_SEC)), stats.charge_uah,
+                stats.energy_uwh);
+#if BUDGET > 0
+    shell_print(sh, "budget %u px, exceeded %u times", BUDGET, stats.budget_trips);
+#endif
+    return 0;
+}
+
+SHELL_SUBCMD_ADD((dongle), power, NULL, "Estimated panel power from the lit pixels", cmd_power,
+                 1, 0);
+#endif
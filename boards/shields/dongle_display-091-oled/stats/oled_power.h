@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct oled_power_stats {
+    // pixels lit on the panel right now, 0 while it is off
+    uint32_t lit;
+    // moving average over the budget window
+    uint32_t avg_lit;
+    // lit pixels integrated over time since boot
+    uint64_t lit_pixel_ms;
+    uint32_t charge_uah;
+    uint32_t energy_uwh;
+    bool over_budget;
+    uint32_t budget_trips;
+};
+
+// Counts the lit pixels of the area LVGL is about to flush, must run on the display work queue.
+void oled_power_record_flush(const lv_area_t *area, const uint8_t *buf);
+// the panel draws no pixel current while it is switched off
+void oled_power_set_panel_on(bool on);
+void oled_power_get_stats(struct oled_power_stats *stats);
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "split_jitter.h"
+
+// ZMK runs the listeners of modules after combos and hold-taps, which hold presses back and release
+// them again later. The gaps are therefore taken from the event timestamps, which the split
+// central sets when a peripheral event arrives and which survive capture and release, at the
+// millisecond resolution of those timestamps. A press swallowed by a combo that fired is never
+// seen, the gap over it is recorded as one.
+struct split_jitter_source {
+    struct histogram hist;
+    int64_t last_timestamp;
+    uint32_t last_position;
+    bool has_last;
+};
+
+static struct split_jitter_source sources[SPLIT_JITTER_SOURCES];
+static uint32_t inversions;
+static int64_t newest_timestamp;
+static uint8_t newest_source;
+
+static struct k_spinlock lock;
+
+static int split_jitter_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    uint8_t index = ev->source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL
+                        ? SPLIT_JITTER_SOURCE_LOCAL
+                        : MIN(ev->source, SPLIT_JITTER_SOURCE_LOCAL);
+    struct split_jitter_source *source = &sources[index];
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    // a press released again after a capture was already recorded when it arrived
+    bool arrival = !source->has_last || ev->timestamp > source->last_timestamp ||
+                   (ev->timestamp == source->last_timestamp && ev->position != source->last_position);
+
+    if (arrival) {
+        int64_t gap_ms = ev->timestamp - source->last_timestamp;
+
+        // pauses between bursts say nothing about the link
+        if (source->has_last && gap_ms <= CONFIG_ZMK_DONGLE_DISPLAY_SPLIT_JITTER_MAX_GAP_MS) {
+            histogram_record(&source->hist, (uint32_t)gap_ms);
+        }
+
+        source->last_timestamp = ev->timestamp;
+        source->last_position = ev->position;
+        source->has_last = true;
+    }
+
+    // handled after a newer event of the other half: a combo or hold-tap held this one back
+    if (ev->timestamp < newest_timestamp && index != newest_source) {
+        inversions++;
+    } else {
+        newest_timestamp = ev->timestamp;
+        newest_source = index;
+    }
+
+    k_spin_unlock(&lock, key);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_split_jitter, split_jitter_listener);
+ZMK_SUBSCRIPTION(dongle_split_jitter, zmk_position_state_changed);
+
+int split_jitter_get(uint8_t source, struct split_jitter_summary *summary) {
+    if (source >= SPLIT_JITTER_SOURCES) {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    const struct histogram *hist = &sources[source].hist;
+    *summary = (struct split_jitter_summary){
+        .count = hist->count,
+        .p50 = histogram_percentile(hist, 50),
+        .p99 = histogram_percentile(hist, 99),
+        .max = hist->max,
+    };
+    k_spin_unlock(&lock, key);
+
+    return 0;
+}
+
+uint32_t split_jitter_inversions(void) { return inversions; }
+
+void split_jitter_reset(void) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    for (int i = 0; i < SPLIT_JITTER_SOURCES; i++) {
+        histogram_reset(&sources[i].hist);
+        sources[i].has_last = false;
+    }
+    inversions = 0;
+    k_spin_unlock(&lock, key);
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+static int cmd_jitter_show(const struct shell *sh, size_t argc, char **argv) {
+    shell_print(sh, "%-10s %8s %8s %8s %8s", "source", "count", "p50_ms", "p99_ms", "max_ms");
+    for (int i = 0; i < SPLIT_JITTER_SOURCES; i++) {
+        struct split_jitter_summary summary;
+        split_jitter_get(i, &summary);
+
+        if (i == SPLIT_JITTER_SOURCE_LOCAL) {
+            shell_print(sh, "%-10s %8u %8u %8u %8u", "local", summary.count, summary.p50,
+                        summary.p99, summary.max);
+        } else {
+            shell_print(sh, "periph %-3d %8u %8u %8u %8u", i, summary.count, summary.p50,
+                        summary.p99, summary.max);
+        }
+    }
+    shell_print(sh, "handled out of arrival order by combos and hold-taps: %u",
+                split_jitter_inversions());
+
+    return 0;
+}
+
+static int cmd_jitter_reset(const struct shell *sh, size_t argc, char **argv) {
+    split_jitter_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_jitter,
+                               SHELL_CMD(show, NULL, "Show inter-arrival times per source",
+                                         cmd_jitter_show),
+                               SHELL_CMD(reset, NULL, "Reset the histograms", cmd_jitter_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_SUBCMD_ADD((dongle), jitter, &sub_jitter, "Split position event jitter", NULL, 1, 0);
+#endif
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <zmk/ble.h>
+
+#include "histogram.h"
+
+// one source per split peripheral plus the keys local to the dongle
+#define SPLIT_JITTER_SOURCES (ZMK_SPLIT_BLE_PERIPHERAL_COUNT + 1)
+#define SPLIT_JITTER_SOURCE_LOCAL ZMK_SPLIT_BLE_PERIPHERAL_COUNT
+
+struct split_jitter_summary {
+    uint32_t count;
+    // inter-arrival times in milliseconds, the resolution of the event timestamps
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+};
+
+int split_jitter_get(uint8_t source, struct split_jitter_summary *summary);
+// Events handled after a newer event from another source. Both halves arrive in order, so this
+// counts presses a combo or hold-tap held back while the other half kept typing.
+uint32_t split_jitter_inversions(void);
+void split_jitter_reset(void);
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/sys_heap.h>
+#include <lvgl_mem.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "telemetry.h"
+
+static struct telemetry_sample latest;
+static struct k_spinlock lock;
+
+static uint64_t last_busy_cycles;
+static uint32_t last_cycles;
+
+static void telemetry_sample_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(telemetry_sample_work, telemetry_sample_work_cb);
+
+struct stack_scan {
+    k_tid_t display_thread;
+    uint8_t peak;
+    uint32_t display_free;
+};
+
+static void scan_thread_stack(const struct k_thread *thread, void *data) {
+    struct stack_scan *scan = data;
+    size_t size = thread->stack_info.size;
+    size_t unused;
+
+    if (size == 0 || k_thread_stack_space_get(thread, &unused) != 0) {
+        return;
+    }
+
+    scan->peak = MAX(scan->peak, (size - unused) * 100 / size);
+    if (thread == scan->display_thread) {
+        scan->display_free = unused;
+    }
+}
+
+// runs on the system work queue at a fixed, low rate
+static void telemetry_sample_work_cb(struct k_work *work) {
+    struct telemetry_sample sample = {};
+    k_tid_t display_thread = k_work_queue_thread_get(zmk_display_work_q());
+
+    k_thread_runtime_stats_t stats;
+    uint32_t now = k_cycle_get_32();
+    if (k_thread_runtime_stats_get(display_thread, &stats) == 0) {
+        uint64_t busy = stats.execution_cycles - last_busy_cycles;
+        uint32_t elapsed = now - last_cycles;
+
+        // the first sample only sets the baseline
+        if (last_busy_cycles != 0 && elapsed != 0) {
+            sample.display_cpu = MIN(busy * 100 / elapsed, 100);
+        }
+        last_busy_cycles = stats.execution_cycles;
+    }
+    last_cycles = now;
+
+    struct sys_memory_stats heap;
+    lvgl_heap_stats(&heap);
+    sample.heap_used = heap.allocated_bytes;
+    sample.heap_peak = heap.max_allocated_bytes;
+
+    // the stacks are scanned without holding the thread list lock, the scan takes a while
+    struct stack_scan scan = {.display_thread = display_thread};
+    k_thread_foreach_unlocked(scan_thread_stack, &scan);
+    sample.stack_peak = scan.peak;
+    sample.display_stack_free = scan.display_free;
+
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    latest = sample;
+    k_spin_unlock(&lock, key);
+
+    k_work_schedule(&telemetry_sample_work, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_TELEMETRY_INTERVAL_MS));
+}
+
+void telemetry_get(struct telemetry_sample *sample) {
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    *sample = latest;
+    k_spin_unlock(&lock, key);
+}
+
+static int telemetry_init(void) {
+    last_cycles = k_cycle_get_32();
+    k_work_schedule(&telemetry_sample_work, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_TELEMETRY_INTERVAL_MS));
+    return 0;
+}
+
+SYS_INIT(telemetry_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
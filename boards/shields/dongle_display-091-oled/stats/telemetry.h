@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+struct telemetry_sample {
+    // share of the last sample interval the display work queue thread ran, in percent
+    uint8_t display_cpu;
+    // LVGL heap in bytes
+    uint32_t heap_used;
+    uint32_t heap_peak;
+    // highest stack usage of any thread, in percent of its stack size
+    uint8_t stack_peak;
+    // unused stack of the display work queue thread, in bytes
+    uint32_t display_stack_free;
+};
+
+void telemetry_get(struct telemetry_sample *sample);
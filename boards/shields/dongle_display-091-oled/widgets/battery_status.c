@@ -4,85 +4,433 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <zephyr/kernel.h>
+#include <zephyr/bluetooth/conn.h>
 #include <zephyr/bluetooth/services/bas.h>
+#include <zephyr/settings/settings.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/display/widgets/battery_status.h>
 #include <zmk/usb.h>
 #include <zmk/ble.h>
 #include <zmk/events/usb_conn_state_changed.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/battery_state_changed.h>
+#include <zmk/events/split_peripheral_status_changed.h>
 
+#include "glyphs.h"
 #include "battery_status.h"
+#include "../stats/bench.h"
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
 struct battery_status_state {
+    enum battery_slot_state state[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
     uint8_t level[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 } battery_state;
 
-struct battery_widget_object {
-    lv_obj_t *battery_label;
+#if BATTERY_COMPACT
+#define GAUGE_STRIDE CANVAS_1BIT_STRIDE(BATTERY_AREA_WIDTH)
+
+// peripheral 0 is the rightmost gauge, like the labels
+#define GAUGE_X(i) ((ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1 - (i)) * BATTERY_GAUGE_STRIDE)
+
+static void set_gauge_column(uint8_t *pixels, int x, bool set) {
+    // the outline rows stay, only the inner rows of the column change
+    canvas_1bit_fill_rect(pixels, GAUGE_STRIDE, x, 1, 1, BATTERY_GAUGE_HEIGHT - 2, set);
+}
+
+static void set_gauge_outline(uint8_t *pixels, int i, bool set) {
+    canvas_1bit_fill_rect(pixels, GAUGE_STRIDE, GAUGE_X(i), 0, BATTERY_GAUGE_STEPS, 1, set);
+    canvas_1bit_fill_rect(pixels, GAUGE_STRIDE, GAUGE_X(i), BATTERY_GAUGE_HEIGHT - 1,
+                          BATTERY_GAUGE_STEPS, 1, set);
+}
+
+// only the columns between the old and the new fill level are redrawn
+static void set_battery_gauge(struct zmk_widget_peripheral_battery_status *widget, int i,
+                              uint8_t level) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+    uint8_t steps = MIN(level, 100) * BATTERY_GAUGE_STEPS / 100;
+    uint8_t old_steps = widget->gauge_steps[i];
+
+    if (steps == old_steps) {
+        return;
+    }
+
+    for (int s = MIN(steps, old_steps); s < MAX(steps, old_steps); s++) {
+        set_gauge_column(pixels, GAUGE_X(i) + s, s < steps);
+    }
+    widget->gauge_steps[i] = steps;
+
+    lv_area_t area = {
+        .x1 = widget->obj->coords.x1 + GAUGE_X(i) + MIN(steps, old_steps),
+        .y1 = widget->obj->coords.y1,
+        .x2 = widget->obj->coords.x1 + GAUGE_X(i) + MAX(steps, old_steps) - 1,
+        .y2 = widget->obj->coords.y1 + BATTERY_GAUGE_HEIGHT - 1,
+    };
+    lv_obj_invalidate_area(widget->obj, &area);
+}
+
+// a disconnected peripheral has no gauge at all, an unknown one an empty gauge
+static void set_battery_slot(struct zmk_widget_peripheral_battery_status *widget, int i,
+                             enum battery_slot_state state, uint8_t level) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+
+    set_battery_gauge(widget, i, state == BATTERY_SLOT_LEVEL ? level : 0);
+
+    if ((state == BATTERY_SLOT_DISCONNECTED) != (widget->drawn_state[i] == BATTERY_SLOT_DISCONNECTED)) {
+        set_gauge_outline(pixels, i, state != BATTERY_SLOT_DISCONNECTED);
+
+        lv_area_t area = {
+            .x1 = widget->obj->coords.x1 + GAUGE_X(i),
+            .y1 = widget->obj->coords.y1,
+            .x2 = widget->obj->coords.x1 + GAUGE_X(i) + BATTERY_GAUGE_STEPS - 1,
+            .y2 = widget->obj->coords.y1 + BATTERY_GAUGE_HEIGHT - 1,
+        };
+        lv_obj_invalidate_area(widget->obj, &area);
+    }
+}
+#else
+static void set_battery_slot(struct zmk_widget_peripheral_battery_status *widget, int i,
+                             enum battery_slot_state state, uint8_t level) {
+    char text[5] = {};
+
+    switch (state) {
+    case BATTERY_SLOT_UNKNOWN:
+        break;
+    case BATTERY_SLOT_DISCONNECTED:
+        strcpy(text, "  --");
+        break;
+    case BATTERY_SLOT_LEVEL:
+        snprintf(text, sizeof(text), "%3u%%", level);
+        break;
+    }
+
+    lv_label_set_text(widget->labels[i], text);
+}
+#endif
+
+static void set_battery_symbol(struct zmk_widget_peripheral_battery_status *widget,
+                               struct battery_status_state state) {
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (state.state[i] == widget->drawn_state[i] &&
+            (state.state[i] != BATTERY_SLOT_LEVEL || state.level[i] == widget->drawn_level[i])) {
+            continue;
+        }
+
+        set_battery_slot(widget, i, state.state[i], state.level[i]);
+        widget->drawn_state[i] = state.state[i];
+        widget->drawn_level[i] = state.level[i];
+    }
+}
+
+// latest reading per peripheral, and the one the widgets show
+struct battery_filter {
+    uint8_t latest;
+    uint8_t reported;
+    bool has_reported;
+    int64_t last_redraw;
 };
 
-struct battery_widget_object battery_widget_objects[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+static struct battery_filter battery_filters[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 
-static void set_battery_symbol(lv_obj_t *widget, struct battery_status_state state) {
-    for (int i = ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1; i >= 0; i--) {  // Iterate backwards
-        uint8_t level = state.level[i];
-        lv_obj_t *label = battery_widget_objects[i].battery_label;
-        
-        char text[5] = {};
+static struct k_spinlock battery_lock;
+
+DONGLE_BENCH_DEFINE(battery_update);
+DONGLE_BENCH_DEFINE(battery_listener);
+
+static void battery_status_update_work_cb(struct k_work *work) {
+    DONGLE_BENCH_BEGIN(battery_update);
+    k_spinlock_key_t key = k_spin_lock(&battery_lock);
+    struct battery_status_state state = battery_state;
+    k_spin_unlock(&battery_lock, key);
+
+    struct zmk_widget_peripheral_battery_status *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_battery_symbol(widget, state); }
+    DONGLE_BENCH_END(battery_update);
+}
+
+static K_WORK_DEFINE(battery_status_update_work, battery_status_update_work_cb);
+
+static bool is_low(uint8_t level) { return level <= CONFIG_ZMK_DONGLE_DISPLAY_BATTERY_LOW_LEVEL; }
+
+// readings jitter by a percent or two, small changes are not worth a redraw
+static bool is_significant(const struct battery_filter *filter, uint8_t level) {
+    if (!filter->has_reported) {
+        return true;
+    }
+
+    if (level == filter->reported) {
+        return false;
+    }
+
+    // low battery is always reported, as is crossing into or out of it
+    if (is_low(level) || is_low(filter->reported)) {
+        return true;
+    }
+
+    return abs(level - filter->reported) >= CONFIG_ZMK_DONGLE_DISPLAY_BATTERY_HYSTERESIS;
+}
 
-        if (level > 0) {
-            snprintf(text, sizeof(text), "%3u%%", level);
+static void battery_deferred_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(battery_deferred_work, battery_deferred_work_cb);
+
+// applies the readings that are significant and due, and returns the time until the next one is
+static k_timeout_t battery_filter_apply(int64_t now) {
+    int64_t next_due = INT64_MAX;
+    bool changed = false;
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        struct battery_filter *filter = &battery_filters[i];
+        uint8_t level = filter->latest;
+
+        if (!is_significant(filter, level)) {
+            continue;
         }
 
-        lv_label_set_text(label, text);
+        int64_t due = filter->last_redraw +
+                      (int64_t)CONFIG_ZMK_DONGLE_DISPLAY_BATTERY_MIN_INTERVAL_S * MSEC_PER_SEC;
+        if (filter->has_reported && !is_low(level) && due > now) {
+            next_due = MIN(next_due, due);
+            continue;
+        }
+
+        filter->reported = level;
+        filter->has_reported = true;
+        filter->last_redraw = now;
+        battery_state.state[i] = BATTERY_SLOT_LEVEL;
+        battery_state.level[i] = level;
+        changed = true;
+    }
+
+    if (changed) {
+        k_work_submit_to_queue(zmk_display_work_q(), &battery_status_update_work);
     }
+
+    return next_due == INT64_MAX ? K_FOREVER : K_MSEC(next_due - now);
 }
 
-void battery_status_update_cb(struct battery_status_state state) {
-    struct zmk_widget_battery_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_battery_symbol(widget->obj, state); }
+static void battery_deferred_work_cb(struct k_work *work) {
+    k_spinlock_key_t key = k_spin_lock(&battery_lock);
+    k_timeout_t next = battery_filter_apply(k_uptime_get());
+    k_spin_unlock(&battery_lock, key);
+
+    if (!K_TIMEOUT_EQ(next, K_FOREVER)) {
+        k_work_reschedule(&battery_deferred_work, next);
+    }
 }
 
-static struct battery_status_state battery_status_get_state(const zmk_event_t *eh) {
+static int battery_status_listener(const zmk_event_t *eh) {
     const struct zmk_peripheral_battery_state_changed *ev = as_zmk_peripheral_battery_state_changed(eh);
-    battery_state.level[ev->source] = ev->state_of_charge;
-    return battery_state;
-}
+    if (ev == NULL) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    if (ev->source >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT) {
+        LOG_WRN("Battery level for unknown peripheral %u", ev->source);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
 
-ZMK_DISPLAY_WIDGET_LISTENER(widget_battery_status, struct battery_status_state,
-                            battery_status_update_cb, battery_status_get_state)
+    DONGLE_BENCH_BEGIN(battery_listener);
+    k_spinlock_key_t key = k_spin_lock(&battery_lock);
+    // a reading proves the link is up, so it is kept even while the slot still looks disconnected:
+    // after a reconnect it usually arrives before peripheral_status_work_cb() has run. The filter
+    // was reset at the disconnect, so it is applied right away and marks the slot connected.
+    battery_filters[ev->source].latest = ev->state_of_charge;
+    k_timeout_t next = battery_filter_apply(k_uptime_get());
+    k_spin_unlock(&battery_lock, key);
+    DONGLE_BENCH_END(battery_listener);
 
+    // a rate limited reading is shown once the minimum interval is over
+    if (!K_TIMEOUT_EQ(next, K_FOREVER)) {
+        k_work_reschedule(&battery_deferred_work, next);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_battery_status, battery_status_listener);
 ZMK_SUBSCRIPTION(widget_battery_status, zmk_peripheral_battery_state_changed);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) &&              \
+    IS_ENABLED(CONFIG_SETTINGS)
+// ZMK keeps the peripheral addresses to itself, so the copies it stores are read back. This relies
+// on a private detail of ZMK, not on an API: the split central saves the bt_addr_le_t of every
+// peripheral it pairs under ble/peripheral_addresses/<slot>, and the slot of an address is also
+// the source of its battery events. Should ZMK store them differently, the subtree reads back
+// empty and the slots are shown as unknown rather than disconnected.
+#define PERIPHERAL_ADDRS_KEY "ble/peripheral_addresses"
+
+struct peripheral_addrs {
+    bt_addr_le_t addr[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+    uint32_t stored;
+};
+
+// Read from flash on the first status change and again only when a split link shows up with an
+// address that is not cached, which is what pairing a new peripheral looks like. There is no
+// settings handler for the subtree: it would take the addresses away from ZMK's own "ble" handler.
+// Only the display work queue touches the cache.
+static struct peripheral_addrs peripheral_addrs;
+static bool peripheral_addrs_loaded;
+
+static int load_peripheral_addr(const char *key, size_t len, settings_read_cb read_cb,
+                                void *cb_arg, void *param) {
+    struct peripheral_addrs *addrs = param;
+    char *end;
+    long slot = strtol(key, &end, 10);
+
+    if (end == key || *end != '\0' || slot < 0 || slot >= ZMK_SPLIT_BLE_PERIPHERAL_COUNT ||
+        len != sizeof(bt_addr_le_t)) {
+        return 0;
+    }
+
+    if (read_cb(cb_arg, &addrs->addr[slot], sizeof(bt_addr_le_t)) == sizeof(bt_addr_le_t)) {
+        addrs->stored |= BIT(slot);
+    }
+    return 0;
+}
+
+static void load_peripheral_addrs(void) {
+    peripheral_addrs = (struct peripheral_addrs){0};
+    settings_load_subtree_direct(PERIPHERAL_ADDRS_KEY, load_peripheral_addr, &peripheral_addrs);
+    peripheral_addrs_loaded = true;
+
+    if (peripheral_addrs.stored == 0) {
+        LOG_WRN("No peripheral addresses under " PERIPHERAL_ADDRS_KEY
+                ", battery slots cannot be matched to split links");
+    }
+}
+
+struct connected_slots {
+    uint32_t connected;
+    // a split link whose address is not cached
+    bool unknown;
+};
+
+// the split links are the central role connections to a stored peripheral address
+static void collect_connected_slot(struct bt_conn *conn, void *data) {
+    struct connected_slots *slots = data;
+    struct bt_conn_info info;
+    bool found = false;
+
+    if (bt_conn_get_info(conn, &info) != 0 || info.role != BT_CONN_ROLE_CENTRAL ||
+        info.state != BT_CONN_STATE_CONNECTED) {
+        return;
+    }
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if ((peripheral_addrs.stored & BIT(i)) &&
+            bt_addr_le_cmp(&peripheral_addrs.addr[i], info.le.dst) == 0) {
+            slots->connected |= BIT(i);
+            found = true;
+        }
+    }
+
+    if (!found) {
+        slots->unknown = true;
+    }
+}
+
+static struct connected_slots find_connected_slots(void) {
+    struct connected_slots slots = {0};
+
+    bt_conn_foreach(BT_CONN_TYPE_LE, collect_connected_slot, &slots);
+    return slots;
+}
+
+// the event does not say which peripheral changed, so every slot is checked against the links
+static void peripheral_status_work_cb(struct k_work *work) {
+    bool loaded_now = !peripheral_addrs_loaded;
+    bool changed = false;
+
+    if (loaded_now) {
+        load_peripheral_addrs();
+    }
+
+    struct connected_slots slots = find_connected_slots();
+    if (slots.unknown && !loaded_now) {
+        load_peripheral_addrs();
+        slots = find_connected_slots();
+    }
+
+    // links that cannot be told apart leave every slot unknown, a slot is only shown disconnected
+    // when it is known to be
+    bool unresolved = slots.unknown && peripheral_addrs.stored == 0;
+
+    k_spinlock_key_t key = k_spin_lock(&battery_lock);
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        bool is_connected = unresolved || (slots.connected & BIT(i));
+
+        if (!is_connected && battery_state.state[i] != BATTERY_SLOT_DISCONNECTED) {
+            // the next reading after a reconnect is shown immediately
+            battery_filters[i] = (struct battery_filter){0};
+            battery_state.state[i] = BATTERY_SLOT_DISCONNECTED;
+            changed = true;
+        } else if (is_connected && battery_state.state[i] == BATTERY_SLOT_DISCONNECTED) {
+            battery_state.state[i] = BATTERY_SLOT_UNKNOWN;
+            changed = true;
+        }
+    }
+    k_spin_unlock(&battery_lock, key);
+
+    if (changed) {
+        k_work_submit_to_queue(zmk_display_work_q(), &battery_status_update_work);
+    }
+}
+
+static K_WORK_DEFINE(peripheral_status_work, peripheral_status_work_cb);
+
+static int peripheral_status_listener(const zmk_event_t *eh) {
+    k_work_submit_to_queue(zmk_display_work_q(), &peripheral_status_work);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_battery_peripheral_status, peripheral_status_listener);
+ZMK_SUBSCRIPTION(widget_battery_peripheral_status, zmk_split_peripheral_status_changed);
+#endif
+
 int zmk_widget_peripheral_battery_status_init(struct zmk_widget_peripheral_battery_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_obj_create(parent);
+#if BATTERY_COMPACT
+    widget->obj = lv_canvas_create(parent);
+    canvas_1bit_init(widget->obj, widget->cbuf, BATTERY_AREA_WIDTH, BATTERY_GAUGE_HEIGHT, false);
 
-    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        set_gauge_outline(CANVAS_1BIT_PIXELS(widget->cbuf), i, true);
+    }
+#else
+    widget->obj = lv_obj_create(parent);
 
-    // Calculate initial x-offset for the rightmost label
-    int initial_x_offset = (ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1) * 35;
+    // positions are fixed at compile time, the rightmost label belongs to peripheral 0
+    lv_obj_set_size(widget->obj, ZMK_SPLIT_BLE_PERIPHERAL_COUNT * BATTERY_LABEL_STRIDE,
+                    BATTERY_LABEL_HEIGHT);
 
     for (int i = ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1; i >= 0; i--) {  // Iterate backwards
-        battery_widget_objects[i].battery_label = lv_label_create(widget->obj);
+        widget->labels[i] = lv_label_create(widget->obj);
 
-        lv_obj_align(battery_widget_objects[i].battery_label, LV_ALIGN_LEFT_MID, initial_x_offset - i * 35, 0);
+        lv_obj_set_pos(widget->labels[i], (ZMK_SPLIT_BLE_PERIPHERAL_COUNT - 1 - i) * BATTERY_LABEL_STRIDE, 0);
+    }
+#endif
+
+    // freshly created slots look unknown, see set_battery_slot()
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        widget->drawn_state[i] = BATTERY_SLOT_UNKNOWN;
     }
 
     sys_slist_append(&widgets, &widget->node);
 
-    widget_battery_status_init();
+    k_spinlock_key_t key = k_spin_lock(&battery_lock);
+    struct battery_status_state state = battery_state;
+    k_spin_unlock(&battery_lock, key);
+
+    set_battery_symbol(widget, state);
     return 0;
 }
 
 lv_obj_t *zmk_widget_peripheral_battery_status_obj(struct zmk_widget_peripheral_battery_status *widget) {
     return widget->obj;
-}
+}
\ No newline at end of file
@@ -8,10 +8,39 @@
 
 #include <lvgl.h>
 #include <zephyr/kernel.h>
+#include <zmk/ble.h>
+
+#define BATTERY_LABEL_STRIDE 35
+#define BATTERY_LABEL_HEIGHT 8
+
+// above two peripherals the percentage labels no longer fit next to each other
+#define BATTERY_COMPACT (ZMK_SPLIT_BLE_PERIPHERAL_COUNT > 2)
+
+// the gauges share the width two labels would take, one pixel column per step
+#define BATTERY_AREA_WIDTH (2 * BATTERY_LABEL_STRIDE)
+#define BATTERY_GAUGE_STRIDE (BATTERY_AREA_WIDTH / MAX(ZMK_SPLIT_BLE_PERIPHERAL_COUNT, 1))
+#define BATTERY_GAUGE_STEPS (BATTERY_GAUGE_STRIDE - 2)
+#define BATTERY_GAUGE_HEIGHT 6
+
+enum battery_slot_state {
+    // nothing heard from the peripheral since boot
+    BATTERY_SLOT_UNKNOWN,
+    BATTERY_SLOT_DISCONNECTED,
+    BATTERY_SLOT_LEVEL,
+};
 
 struct zmk_widget_peripheral_battery_status {
     sys_snode_t node;
     lv_obj_t *obj;
+#if BATTERY_COMPACT
+    uint8_t cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(BATTERY_AREA_WIDTH, BATTERY_GAUGE_HEIGHT)];
+    uint8_t gauge_steps[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+#else
+    lv_obj_t *labels[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+#endif
+    // what each slot shows, so an update only touches the slots that changed
+    enum battery_slot_state drawn_state[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+    uint8_t drawn_level[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 };
 
 int zmk_widget_peripheral_battery_status_init(struct zmk_widget_peripheral_battery_status *widget, lv_obj_t *parent);
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/bluetooth/services/bas.h>
 
@@ -15,7 +17,14 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/wpm_state_changed.h>
 #include <zmk/wpm.h>
 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM)
+#include "../events/local_wpm_changed.h"
+#include "../wpm_estimator.h"
+#endif
+
+#include "glyphs.h"
 #include "bongo_cat.h"
+#include "../stats/bench.h"
 
 #define SRC(array) (const void **)array, sizeof(array) / sizeof(lv_img_dsc_t *)
 
@@ -69,6 +78,61 @@ const lv_img_dsc_t *fast_imgs[] = {
     &bongo_cat_none,
 };
 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_LIGHT_CAT)
+static const lv_img_dsc_t *const frames[] = {
+    &bongo_cat_none,  &bongo_cat_left1, &bongo_cat_left2,      &bongo_cat_right1,
+    &bongo_cat_right2, &bongo_cat_both1, &bongo_cat_both1_open, &bongo_cat_both2,
+};
+
+// all frames share one size, see glyphs.h for the layout
+#define FRAME_STRIDE CANVAS_1BIT_STRIDE(50)
+#define FRAME_SIZE (CANVAS_1BIT_PALETTE_SIZE + FRAME_STRIDE * 26)
+
+static uint8_t light_maps[ARRAY_SIZE(frames)][FRAME_SIZE];
+static lv_img_dsc_t light_frames[ARRAY_SIZE(frames)];
+
+static const lv_img_dsc_t *idle_imgs_light[ARRAY_SIZE(idle_imgs)];
+static const lv_img_dsc_t *slow_imgs_light[ARRAY_SIZE(slow_imgs)];
+static const lv_img_dsc_t *mid_imgs_light[ARRAY_SIZE(mid_imgs)];
+static const lv_img_dsc_t *fast_imgs_light[ARRAY_SIZE(fast_imgs)];
+
+static bool light;
+
+// a checkerboard mask halves the lit pixels of the strokes while keeping their shape readable
+static void render_light_frames(void) {
+    for (int i = 0; i < ARRAY_SIZE(frames); i++) {
+        __ASSERT(frames[i]->data_size == FRAME_SIZE, "Unexpected bongo cat frame size");
+
+        memcpy(light_maps[i], frames[i]->data, FRAME_SIZE);
+        for (int row = 0; row < 26; row++) {
+            uint8_t mask = row % 2 ? 0x55 : 0xaa;
+            for (int b = 0; b < FRAME_STRIDE; b++) {
+                CANVAS_1BIT_PIXELS(light_maps[i])[row * FRAME_STRIDE + b] &= mask;
+            }
+        }
+
+        light_frames[i] = *frames[i];
+        light_frames[i].data = light_maps[i];
+    }
+}
+
+static void map_light_frames(const lv_img_dsc_t **light_imgs, const lv_img_dsc_t *const *imgs,
+                             size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        for (int f = 0; f < ARRAY_SIZE(frames); f++) {
+            if (imgs[i] == frames[f]) {
+                light_imgs[i] = &light_frames[f];
+            }
+        }
+    }
+}
+
+#define ANIM_SRC(array)                                                                            \
+    (light ? (const void **)array##_light : (const void **)array), ARRAY_SIZE(array)
+#else
+#define ANIM_SRC(array) SRC(array)
+#endif
+
 struct bongo_cat_wpm_status_state {
     uint8_t wpm;
 };
@@ -84,7 +148,7 @@ enum anim_state {
 static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state state) {
     if (state.wpm < 5) {
         if (current_anim_state != anim_state_idle) {
-            lv_animimg_set_src(animing, SRC(idle_imgs));
+            lv_animimg_set_src(animing, ANIM_SRC(idle_imgs));
             lv_animimg_set_duration(animing, ANIMATION_SPEED_IDLE);
             lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
             lv_animimg_start(animing);
@@ -92,7 +156,7 @@ static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state s
         }
     } else if (state.wpm < 30) {
         if (current_anim_state != anim_state_slow) {
-            lv_animimg_set_src(animing, SRC(slow_imgs));
+            lv_animimg_set_src(animing, ANIM_SRC(slow_imgs));
             lv_animimg_set_duration(animing, ANIMATION_SPEED_SLOW);
             lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
             lv_animimg_start(animing);
@@ -100,7 +164,7 @@ static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state s
         }
     } else if (state.wpm < 70) {
         if (current_anim_state != anim_state_mid) {
-            lv_animimg_set_src(animing, SRC(mid_imgs));
+            lv_animimg_set_src(animing, ANIM_SRC(mid_imgs));
             lv_animimg_set_duration(animing, ANIMATION_SPEED_MID);
             lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
             lv_animimg_start(animing);
@@ -108,7 +172,7 @@ static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state s
         }
     } else {
         if (current_anim_state != anim_state_fast) {
-            lv_animimg_set_src(animing, SRC(fast_imgs));
+            lv_animimg_set_src(animing, ANIM_SRC(fast_imgs));
             lv_animimg_set_duration(animing, ANIMATION_SPEED_FAST);
             lv_animimg_set_repeat_count(animing, LV_ANIM_REPEAT_INFINITE);
             lv_animimg_start(animing);
@@ -118,21 +182,64 @@ static void set_animation(lv_obj_t *animing, struct bongo_cat_wpm_status_state s
 }
 
 struct bongo_cat_wpm_status_state bongo_cat_wpm_status_get_state(const zmk_event_t *eh) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM)
+    // called without an event when the widget is initialized
+    if (eh == NULL) {
+        return (struct bongo_cat_wpm_status_state) { .wpm = wpm_estimator_get() };
+    }
+    const struct zmk_local_wpm_changed *ev = as_zmk_local_wpm_changed(eh);
+#else
     struct zmk_wpm_state_changed *ev = as_zmk_wpm_state_changed(eh);
+#endif
     return (struct bongo_cat_wpm_status_state) { .wpm = ev->state };
 };
 
+DONGLE_BENCH_DEFINE(bongo_update);
+
+static struct bongo_cat_wpm_status_state last_state;
+
 void bongo_cat_wpm_status_update_cb(struct bongo_cat_wpm_status_state state) {
+    DONGLE_BENCH_BEGIN(bongo_update);
+    last_state = state;
     struct zmk_widget_bongo_cat *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_animation(widget->obj, state); }
+    DONGLE_BENCH_END(bongo_update);
 }
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_bongo_cat, struct bongo_cat_wpm_status_state,
                             bongo_cat_wpm_status_update_cb, bongo_cat_wpm_status_get_state)
 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM)
+ZMK_SUBSCRIPTION(widget_bongo_cat, zmk_local_wpm_changed);
+#else
 ZMK_SUBSCRIPTION(widget_bongo_cat, zmk_wpm_state_changed);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_LIGHT_CAT)
+void zmk_widget_bongo_cat_set_light(bool is_light) {
+    if (is_light == light) {
+        return;
+    }
+
+    light = is_light;
+
+    // forces the running animation to restart with the other frames
+    current_anim_state = anim_state_none;
+    bongo_cat_wpm_status_update_cb(last_state);
+}
+#endif
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_OLED_BUDGET_LIGHT_CAT)
+    if (idle_imgs_light[0] == NULL) {
+        render_light_frames();
+        map_light_frames(idle_imgs_light, idle_imgs, ARRAY_SIZE(idle_imgs));
+        map_light_frames(slow_imgs_light, slow_imgs, ARRAY_SIZE(slow_imgs));
+        map_light_frames(mid_imgs_light, mid_imgs, ARRAY_SIZE(mid_imgs));
+        map_light_frames(fast_imgs_light, fast_imgs, ARRAY_SIZE(fast_imgs));
+    }
+#endif
+
     widget->obj = lv_animimg_create(parent);
     lv_obj_center(widget->obj);
 
@@ -16,4 +16,7 @@ struct zmk_widget_bongo_cat {
 };
 
 int zmk_widget_bongo_cat_init(struct zmk_widget_bongo_cat *widget, lv_obj_t *parent);
-lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget);
\ No newline at end of file
+lv_obj_t *zmk_widget_bongo_cat_obj(struct zmk_widget_bongo_cat *widget);
+// switches to the light variant of the frames with every other pixel of the strokes left out,
+// must run on the display work queue
+void zmk_widget_bongo_cat_set_light(bool light);
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "clock.h"
+#include "../stats/bench.h"
+#include "../stats/host_time.h"
+
+#define CLOCK_STRIDE CANVAS_1BIT_STRIDE(CLOCK_WIDTH)
+#define CLOCK_CELL_WIDTH (GLYPH_PITCH * CLOCK_SCALE)
+
+#define MSEC_PER_MINUTE (60 * MSEC_PER_SEC)
+#define MINUTES_PER_DAY (24 * 60)
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+static void clock_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(clock_work, clock_work_cb);
+
+DONGLE_BENCH_DEFINE(clock_update);
+
+// only the characters that differ from what is drawn are blitted and invalidated
+static void set_clock(struct zmk_widget_clock *widget, const char *text) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+    int first = -1, last = -1;
+
+    for (int i = 0; i < CLOCK_CHARS; i++) {
+        if (text[i] == widget->drawn[i]) {
+            continue;
+        }
+
+        glyph_blit(pixels, CLOCK_STRIDE, i * CLOCK_CELL_WIDTH, 0, text[i], CLOCK_SCALE);
+        widget->drawn[i] = text[i];
+        if (first < 0) {
+            first = i;
+        }
+        last = i;
+    }
+
+    if (first < 0) {
+        return;
+    }
+
+    lv_area_t area = {
+        .x1 = widget->obj->coords.x1 + first * CLOCK_CELL_WIDTH,
+        .y1 = widget->obj->coords.y1,
+        .x2 = widget->obj->coords.x1 + (last + 1) * CLOCK_CELL_WIDTH - 1,
+        .y2 = widget->obj->coords.y1 + CLOCK_HEIGHT - 1,
+    };
+    lv_obj_invalidate_area(widget->obj, &area);
+}
+
+void zmk_widget_clock_refresh(void) {
+    char text[CLOCK_CHARS + 1] = "--:--";
+    int64_t now;
+
+    DONGLE_BENCH_BEGIN(clock_update);
+
+    if (host_time_now(&now)) {
+        uint32_t minute = (uint32_t)(now / MSEC_PER_MINUTE % MINUTES_PER_DAY);
+
+        snprintf(text, sizeof(text), "%02u:%02u", minute / 60, minute % 60);
+
+        // once per minute, on the minute; a new sync moves the next redraw accordingly
+        k_work_reschedule_for_queue(zmk_display_work_q(), &clock_work,
+                                    K_MSEC(MSEC_PER_MINUTE - now % MSEC_PER_MINUTE));
+    }
+
+    struct zmk_widget_clock *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_clock(widget, text); }
+
+    DONGLE_BENCH_END(clock_update);
+}
+
+static void clock_work_cb(struct k_work *work) { zmk_widget_clock_refresh(); }
+
+int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent) {
+    widget->obj = lv_canvas_create(parent);
+    canvas_1bit_init(widget->obj, widget->cbuf, CLOCK_WIDTH, CLOCK_HEIGHT, false);
+    memset(widget->drawn, ' ', CLOCK_CHARS);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    zmk_widget_clock_refresh();
+    return 0;
+}
+
+lv_obj_t *zmk_widget_clock_obj(struct zmk_widget_clock *widget) {
+    return widget->obj;
+}
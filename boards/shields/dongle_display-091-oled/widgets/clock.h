@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#include "glyphs.h"
+
+// hh:mm in glyphs scaled to the height of the modifier symbols
+#define CLOCK_CHARS 5
+#define CLOCK_SCALE 3
+#define CLOCK_WIDTH (CLOCK_CHARS * GLYPH_PITCH * CLOCK_SCALE)
+#define CLOCK_HEIGHT (GLYPH_HEIGHT * CLOCK_SCALE)
+
+struct zmk_widget_clock {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    uint8_t cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(CLOCK_WIDTH, CLOCK_HEIGHT)];
+    // characters currently drawn
+    char drawn[CLOCK_CHARS];
+};
+
+int zmk_widget_clock_init(struct zmk_widget_clock *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_clock_obj(struct zmk_widget_clock *widget);
+// redraws the changed digits and schedules the next redraw at the following minute, must run on
+// the display work queue
+void zmk_widget_clock_refresh(void);
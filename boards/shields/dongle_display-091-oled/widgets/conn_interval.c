@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "conn_interval.h"
+#include "../conn_interval.h"
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// first line is the requested mode, then one line per split link with the negotiated interval
+static void set_conn_interval_text(lv_obj_t *label) {
+    char text[64] = {};
+    int len = snprintf(text, sizeof(text), "%s",
+                       conn_interval_get_mode() == conn_interval_mode_fast ? "fast" : "slow");
+
+    for (int i = 0; i < CONFIG_BT_MAX_CONN && len < sizeof(text); i++) {
+        struct conn_interval_link link;
+        conn_interval_get_link(i, &link);
+
+        if (link.connected) {
+            len += snprintf(text + len, sizeof(text) - len, "\n%u.%02ums L%u",
+                            link.interval * 5 / 4, (link.interval * 125) % 100, link.latency);
+        }
+    }
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void zmk_widget_conn_interval_refresh(void) {
+    struct zmk_widget_conn_interval *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_conn_interval_text(widget->obj); }
+}
+
+int zmk_widget_conn_interval_init(struct zmk_widget_conn_interval *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    set_conn_interval_text(widget->obj);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_conn_interval_obj(struct zmk_widget_conn_interval *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_conn_interval {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int zmk_widget_conn_interval_init(struct zmk_widget_conn_interval *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_conn_interval_obj(struct zmk_widget_conn_interval *widget);
+void zmk_widget_conn_interval_refresh(void);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "decision_latency.h"
+#include "../stats/decision_latency.h"
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// percentiles over all positions in ms, then the position with the highest average
+static void set_decision_latency_text(lv_obj_t *label) {
+    struct histogram hist;
+    uint32_t position, avg;
+    char text[48] = {};
+
+    decision_latency_get_overall(&hist);
+
+    int len = snprintf(text, sizeof(text), "p50 %u p99 %u\nmax %u ms",
+                       histogram_percentile(&hist, 50), histogram_percentile(&hist, 99), hist.max);
+
+    if (decision_latency_slowest_position(&position, &avg) == 0 && len < sizeof(text)) {
+        snprintf(text + len, sizeof(text) - len, "\nslow #%u %u", position, avg);
+    }
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void zmk_widget_decision_latency_refresh(void) {
+    struct zmk_widget_decision_latency *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        set_decision_latency_text(widget->obj);
+    }
+}
+
+int zmk_widget_decision_latency_init(struct zmk_widget_decision_latency *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    set_decision_latency_text(widget->obj);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_decision_latency_obj(struct zmk_widget_decision_latency *widget) {
+    return widget->obj;
+}
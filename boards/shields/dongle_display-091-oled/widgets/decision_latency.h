@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_decision_latency {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int zmk_widget_decision_latency_init(struct zmk_widget_decision_latency *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_decision_latency_obj(struct zmk_widget_decision_latency *widget);
+void zmk_widget_decision_latency_refresh(void);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include "glyphs.h"
+
+static const char glyph_chars[] = "0123456789%:-ACDEFHKMPRSTU";
+
+// each row is three bits with the leftmost pixel in bit 2
+static const uint8_t glyphs[][GLYPH_HEIGHT] = {
+    {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+    {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7},
+    {5, 1, 2, 4, 5}, {0, 2, 0, 2, 0}, {0, 0, 7, 0, 0}, {2, 5, 7, 5, 5}, {7, 4, 4, 4, 7},
+    {6, 5, 5, 5, 6}, {7, 4, 7, 4, 7}, {7, 4, 6, 4, 4}, {5, 5, 7, 5, 5}, {5, 5, 6, 5, 5},
+    {5, 7, 7, 5, 5}, {7, 5, 7, 4, 4}, {6, 5, 6, 5, 5}, {3, 4, 2, 1, 6}, {7, 2, 2, 2, 2},
+    {5, 5, 5, 5, 7},
+};
+
+BUILD_ASSERT(ARRAY_SIZE(glyphs) == sizeof(glyph_chars) - 1, "Every glyph needs a bitmap");
+
+void canvas_1bit_set_palette(uint8_t *buf, bool transparent) {
+    lv_color32_t *palette = (lv_color32_t *)buf;
+
+    palette[0].full = lv_color_to32(lv_color_white());
+    if (transparent) {
+        palette[0].ch.alpha = LV_OPA_TRANSP;
+    }
+    palette[1].full = lv_color_to32(lv_color_black());
+}
+
+void canvas_1bit_init(lv_obj_t *canvas, uint8_t *cbuf, int width, int height, bool transparent) {
+    lv_canvas_set_buffer(canvas, cbuf, width, height, LV_IMG_CF_INDEXED_1BIT);
+    canvas_1bit_set_palette(cbuf, transparent);
+    memset(CANVAS_1BIT_PIXELS(cbuf), 0, CANVAS_1BIT_STRIDE(width) * height);
+}
+
+void canvas_1bit_set_px(uint8_t *pixels, int stride, int x, int y, bool on) {
+    uint8_t *byte = &pixels[y * stride + x / 8];
+
+    if (on) {
+        *byte |= BIT(7 - x % 8);
+    } else {
+        *byte &= ~BIT(7 - x % 8);
+    }
+}
+
+void canvas_1bit_fill_rect(uint8_t *pixels, int stride, int x0, int y0, int w, int h, bool on) {
+    for (int y = y0; y < y0 + h; y++) {
+        for (int x = x0; x < x0 + w; x++) {
+            canvas_1bit_set_px(pixels, stride, x, y, on);
+        }
+    }
+}
+
+void glyph_blit(uint8_t *pixels, int stride, int x0, int y0, char c, int scale) {
+    const char *found = c ? strchr(glyph_chars, c) : NULL;
+    const uint8_t *glyph = found ? glyphs[found - glyph_chars] : NULL;
+
+    for (int y = 0; y < GLYPH_HEIGHT * scale; y++) {
+        for (int x = 0; x < GLYPH_PITCH * scale; x++) {
+            int gx = x / scale;
+            bool on = glyph && gx < GLYPH_WIDTH && (glyph[y / scale] & BIT(GLYPH_WIDTH - 1 - gx));
+
+            canvas_1bit_set_px(pixels, stride, x0 + x, y0 + y, on);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+#include <lvgl.h>
+
+// Indexed 1 bit canvases and images: two palette entries followed by rows of (width + 7) / 8
+// bytes, MSB first. Index 0 is the background, index 1 the foreground.
+#define CANVAS_1BIT_PALETTE_SIZE (2 * sizeof(lv_color32_t))
+#define CANVAS_1BIT_STRIDE(width) (((width) + 7) / 8)
+#define CANVAS_1BIT_PIXELS(buf) ((buf) + CANVAS_1BIT_PALETTE_SIZE)
+
+// Writes a white or a transparent background and a black foreground to the palette of buf. A
+// transparent background keeps the unset pixels from painting over the widgets underneath.
+void canvas_1bit_set_palette(uint8_t *buf, bool transparent);
+// Points canvas at cbuf, LV_CANVAS_BUF_SIZE_INDEXED_1BIT(width, height) bytes, and clears it.
+void canvas_1bit_init(lv_obj_t *canvas, uint8_t *cbuf, int width, int height, bool transparent);
+void canvas_1bit_set_px(uint8_t *pixels, int stride, int x, int y, bool on);
+void canvas_1bit_fill_rect(uint8_t *pixels, int stride, int x0, int y0, int w, int h, bool on);
+
+// 3x5 glyphs on a 4 pixel pitch, for widgets that redraw single characters of a 1 bit canvas
+#define GLYPH_WIDTH 3
+#define GLYPH_HEIGHT 5
+#define GLYPH_PITCH 4
+
+// Draws c into the GLYPH_PITCH by GLYPH_HEIGHT cell at x0, y0, both times scale. pixels are rows
+// of stride bytes, MSB first. Characters without a glyph, like space, are left blank.
+void glyph_blit(uint8_t *pixels, int stride, int x0, int y0, char c, int scale);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+
+#include "hid_rate.h"
+#include "modifiers.h"
+#include "../stats/hid_rate.h"
+#include "../stats/bench.h"
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// Rate of the last second / peak of the window, keycodes on top and modifiers below. At 9 px per
+// character only 6 fit the footprint of the modifier symbols, so the rates stop at 99.
+#define HID_RATE_MAX 99
+
+static void set_hid_rate_text(lv_obj_t *label, struct hid_rate rate) {
+    char text[16] = {};
+
+    snprintf(text, sizeof(text), "%u/%u\n%u/%u", MIN(rate.keycodes, HID_RATE_MAX),
+             MIN(rate.keycodes_peak, HID_RATE_MAX), MIN(rate.modifiers, HID_RATE_MAX),
+             MIN(rate.modifiers_peak, HID_RATE_MAX));
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+static void hid_rate_render_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(hid_rate_render_work, hid_rate_render_work_cb);
+
+// the counters are updated in the event path, the label at most once per second
+DONGLE_BENCH_DEFINE(hid_rate_update);
+
+static void hid_rate_render_work_cb(struct k_work *work) {
+    DONGLE_BENCH_BEGIN(hid_rate_update);
+    struct hid_rate rate;
+    hid_rate_get(&rate);
+
+    struct zmk_widget_hid_rate *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_hid_rate_text(widget->obj, rate); }
+    DONGLE_BENCH_END(hid_rate_update);
+
+    k_work_schedule_for_queue(zmk_display_work_q(), &hid_rate_render_work, K_SECONDS(1));
+}
+
+int zmk_widget_hid_rate_init(struct zmk_widget_hid_rate *widget, lv_obj_t *parent) {
+    // takes the place of the modifier symbols, so it uses the same footprint
+    widget->obj = lv_label_create(parent);
+    lv_obj_set_size(widget->obj, 4 * (SIZE_SYMBOLS + 1) + 1, SIZE_SYMBOLS + 3);
+    lv_label_set_long_mode(widget->obj, LV_LABEL_LONG_CLIP);
+    lv_label_set_text(widget->obj, "");
+
+    sys_slist_append(&widgets, &widget->node);
+
+    k_work_schedule_for_queue(zmk_display_work_q(), &hid_rate_render_work, K_NO_WAIT);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_hid_rate_obj(struct zmk_widget_hid_rate *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_hid_rate {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int zmk_widget_hid_rate_init(struct zmk_widget_hid_rate *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_hid_rate_obj(struct zmk_widget_hid_rate *widget);
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/matrix.h>
+
+#include "glyphs.h"
+#include "key_matrix.h"
+#include "../stats/bench.h"
+
+#define MATRIX_STRIDE CANVAS_1BIT_STRIDE(KEY_MATRIX_WIDTH)
+
+#define MATRIX_ROWS CONFIG_ZMK_DONGLE_DISPLAY_KEY_MATRIX_ROWS
+#define MATRIX_COLS DIV_ROUND_UP(ZMK_KEYMAP_LEN, MATRIX_ROWS)
+#define CELL_WIDTH (KEY_MATRIX_WIDTH / MATRIX_COLS)
+#define CELL_HEIGHT (KEY_MATRIX_HEIGHT / MATRIX_ROWS)
+
+BUILD_ASSERT(CELL_WIDTH >= 3 && CELL_HEIGHT >= 3, "Too many key positions for the key matrix page");
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// written by the event listener, only the display work queue reads and renders it
+static ATOMIC_DEFINE(pressed, ZMK_KEYMAP_LEN);
+// what is currently drawn on the canvas
+static atomic_val_t rendered[ATOMIC_BITMAP_SIZE(ZMK_KEYMAP_LEN)];
+
+// released keys are outlined, pressed keys are filled; cells keep a one pixel gap
+static void draw_key(struct zmk_widget_key_matrix *widget, int position, bool is_pressed) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+    int x = (position % MATRIX_COLS) * CELL_WIDTH;
+    int y = (position / MATRIX_COLS) * CELL_HEIGHT;
+    int w = CELL_WIDTH - 1;
+    int h = CELL_HEIGHT - 1;
+
+    canvas_1bit_fill_rect(pixels, MATRIX_STRIDE, x, y, w, h, true);
+    if (!is_pressed) {
+        canvas_1bit_fill_rect(pixels, MATRIX_STRIDE, x + 1, y + 1, w - 2, h - 2, false);
+    }
+
+    lv_area_t area = {
+        .x1 = widget->obj->coords.x1 + x,
+        .y1 = widget->obj->coords.y1 + y,
+        .x2 = widget->obj->coords.x1 + x + w - 1,
+        .y2 = widget->obj->coords.y1 + y + h - 1,
+    };
+    lv_obj_invalidate_area(widget->obj, &area);
+}
+
+DONGLE_BENCH_DEFINE(matrix_update);
+DONGLE_BENCH_DEFINE(matrix_listener);
+
+static void key_matrix_render_work_cb(struct k_work *work) {
+    DONGLE_BENCH_BEGIN(matrix_update);
+    for (int i = 0; i < ARRAY_SIZE(rendered); i++) {
+        atomic_val_t current = atomic_get(&pressed[i]);
+        atomic_val_t flipped = current ^ rendered[i];
+
+        // only the keys whose bit flipped since the last frame are redrawn
+        while (flipped) {
+            int bit = __builtin_ctzl(flipped);
+            int position = i * ATOMIC_BITS + bit;
+            flipped &= flipped - 1;
+
+            if (position >= ZMK_KEYMAP_LEN) {
+                break;
+            }
+
+            struct zmk_widget_key_matrix *widget;
+            SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+                draw_key(widget, position, current & BIT(bit));
+            }
+        }
+
+        rendered[i] = current;
+    }
+    DONGLE_BENCH_END(matrix_update);
+}
+
+static K_WORK_DEFINE(key_matrix_render_work, key_matrix_render_work_cb);
+
+// no event is queued: the bitset holds the latest state and a pending render picks it up
+static int key_matrix_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev == NULL || ev->position >= ZMK_KEYMAP_LEN) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    DONGLE_BENCH_BEGIN(matrix_listener);
+    atomic_set_bit_to(pressed, ev->position, ev->state);
+    k_work_submit_to_queue(zmk_display_work_q(), &key_matrix_render_work);
+    DONGLE_BENCH_END(matrix_listener);
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_key_matrix, key_matrix_listener);
+ZMK_SUBSCRIPTION(widget_key_matrix, zmk_position_state_changed);
+
+int zmk_widget_key_matrix_init(struct zmk_widget_key_matrix *widget, lv_obj_t *parent) {
+    widget->obj = lv_canvas_create(parent);
+    canvas_1bit_init(widget->obj, widget->cbuf, KEY_MATRIX_WIDTH, KEY_MATRIX_HEIGHT, false);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    for (int i = 0; i < ZMK_KEYMAP_LEN; i++) {
+        draw_key(widget, i, atomic_test_bit(rendered, i));
+    }
+
+    return 0;
+}
+
+lv_obj_t *zmk_widget_key_matrix_obj(struct zmk_widget_key_matrix *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#define KEY_MATRIX_WIDTH 128
+#define KEY_MATRIX_HEIGHT 32
+
+struct zmk_widget_key_matrix {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    uint8_t cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(KEY_MATRIX_WIDTH, KEY_MATRIX_HEIGHT)];
+};
+
+int zmk_widget_key_matrix_init(struct zmk_widget_key_matrix *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_key_matrix_obj(struct zmk_widget_key_matrix *widget);
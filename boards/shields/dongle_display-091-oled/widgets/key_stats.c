@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "key_stats.h"
+#include "../stats/key_stats.h"
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// total presses, the most used layer with its share and the number of flash writes
+static void set_key_stats_text(lv_obj_t *label) {
+    struct key_stats_summary summary;
+    char text[48] = {};
+
+    key_stats_get_summary(&summary);
+
+    snprintf(text, sizeof(text), "sum %u\ntop L%u %u%%\nflash %u", summary.total,
+             summary.top_layer,
+             summary.total ? (uint32_t)((uint64_t)summary.top_layer_presses * 100 / summary.total)
+                           : 0,
+             summary.flushes);
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void zmk_widget_key_stats_refresh(void) {
+    struct zmk_widget_key_stats *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_key_stats_text(widget->obj); }
+}
+
+int zmk_widget_key_stats_init(struct zmk_widget_key_stats *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    set_key_stats_text(widget->obj);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_key_stats_obj(struct zmk_widget_key_stats *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_key_stats {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int zmk_widget_key_stats_init(struct zmk_widget_key_stats *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_key_stats_obj(struct zmk_widget_key_stats *widget);
+void zmk_widget_key_stats_refresh(void);
@@ -4,51 +4,220 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/display.h>
-#include <zmk/display/widgets/layer_status.h>
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/event_manager.h>
 #include <zmk/endpoints.h>
 #include <zmk/keymap.h>
 
+#include "glyphs.h"
+#include "layer_status.h"
+#include "../stats/bench.h"
+
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
 struct layer_status_state {
     uint8_t index;
     const char *label;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+    zmk_keymap_layers_state_t layers;
+#endif
 };
 
-static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
-    if (state.label == NULL) {
-        char text[7] = {};
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+// layer i is drawn in column i % LAYER_STACK_COLUMNS of row i / LAYER_STACK_COLUMNS
+#define LAYER_STACK_STRIDE CANVAS_1BIT_STRIDE(LAYER_STACK_WIDTH)
+
+// active layers are drawn as filled blocks, inactive ones only as their bottom row
+static void draw_layer_block(struct zmk_widget_layer_status *widget, int layer, bool active) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->stack_cbuf);
+    int x0 = (layer % LAYER_STACK_COLUMNS) * (LAYER_STACK_BLOCK_WIDTH + 1);
+    int y0 = (layer / LAYER_STACK_COLUMNS) * (LAYER_STACK_BLOCK_HEIGHT + 1);
+
+    canvas_1bit_fill_rect(pixels, LAYER_STACK_STRIDE, x0, y0, LAYER_STACK_BLOCK_WIDTH,
+                          LAYER_STACK_BLOCK_HEIGHT - 1, active);
+    canvas_1bit_fill_rect(pixels, LAYER_STACK_STRIDE, x0, y0 + LAYER_STACK_BLOCK_HEIGHT - 1,
+                          LAYER_STACK_BLOCK_WIDTH, 1, true);
+
+    lv_area_t area = {
+        .x1 = widget->stack->coords.x1 + x0,
+        .y1 = widget->stack->coords.y1 + y0,
+        .x2 = widget->stack->coords.x1 + x0 + LAYER_STACK_BLOCK_WIDTH - 1,
+        .y2 = widget->stack->coords.y1 + y0 + LAYER_STACK_BLOCK_HEIGHT - 1,
+    };
+    lv_obj_invalidate_area(widget->stack, &area);
+}
+
+static void set_layer_stack(struct zmk_widget_layer_status *widget, zmk_keymap_layers_state_t layers) {
+    zmk_keymap_layers_state_t changed = layers ^ widget->rendered_layers;
 
-        sprintf(text, "%i", state.index);
+    for (int i = 0; i < LAYER_STACK_LAYERS; i++) {
+        if (changed & BIT(i)) {
+            draw_layer_block(widget, i, layers & BIT(i));
+        }
+    }
 
-        lv_label_set_text(label, text);
+    widget->rendered_layers = layers;
+}
+#endif
+
+static void format_layer_name(char *text, size_t len, uint8_t index, const char *label) {
+    if (label == NULL) {
+        snprintf(text, MIN(len, 7), "%i", index);
     } else {
-        char text[13] = {};
+        snprintf(text, MIN(len, 13), "%s", label);
+    }
+}
+
+#define LAYER_NAME_WIDTH CONFIG_ZMK_DONGLE_DISPLAY_LAYER_NAME_WIDTH
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_NAME_CACHE)
+#define LAYER_NAME_HEIGHT 8
+#define LAYER_NAME_STRIDE CANVAS_1BIT_STRIDE(LAYER_NAME_WIDTH)
+
+struct layer_name_glyph {
+    lv_img_dsc_t dsc;
+    uint8_t map[CANVAS_1BIT_PALETTE_SIZE + LAYER_NAME_STRIDE * LAYER_NAME_HEIGHT];
+};
+
+static struct layer_name_glyph layer_name_glyphs[ZMK_KEYMAP_LAYERS_LEN];
+// the text each glyph was rendered from, to notice names changed at runtime
+static char layer_name_texts[ZMK_KEYMAP_LAYERS_LEN][13];
+static bool layer_name_glyphs_rendered;
+
+// converts one rendered name from the true color scratch canvas to an indexed 1 bit image
+static void pack_layer_name_glyph(lv_obj_t *scratch, struct layer_name_glyph *glyph) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(glyph->map);
+
+    // the unused part of the strip must not paint over the widgets it overlaps, such as the top
+    // rows of the bongo cat
+    canvas_1bit_set_palette(glyph->map, true);
+
+    for (int y = 0; y < LAYER_NAME_HEIGHT; y++) {
+        for (int x = 0; x < LAYER_NAME_WIDTH; x++) {
+            bool on = lv_color_brightness(lv_canvas_get_px(scratch, x, y)) < 128;
+            canvas_1bit_set_px(pixels, LAYER_NAME_STRIDE, x, y, on);
+        }
+    }
+
+    glyph->dsc = (lv_img_dsc_t){
+        .header.cf = LV_IMG_CF_INDEXED_1BIT,
+        .header.always_zero = 0,
+        .header.reserved = 0,
+        .header.w = LAYER_NAME_WIDTH,
+        .header.h = LAYER_NAME_HEIGHT,
+        .data_size = sizeof(glyph->map),
+        .data = glyph->map,
+    };
+}
+
+// Text layout and glyph rendering happen here, at startup for every layer and later only for a
+// layer whose name changed; a layer switch just swaps the image source. layers is a bitmask.
+static void render_layer_name_glyphs(lv_obj_t *parent, uint32_t layers) {
+    uint8_t *scratch_buf =
+        lv_mem_alloc(LV_CANVAS_BUF_SIZE_TRUE_COLOR(LAYER_NAME_WIDTH, LAYER_NAME_HEIGHT));
+    if (scratch_buf == NULL) {
+        LOG_ERR("No memory to render the layer names");
+        return;
+    }
+
+    // hidden, so a rename does not invalidate the screen under it
+    lv_obj_t *scratch = lv_canvas_create(parent);
+    lv_obj_add_flag(scratch, LV_OBJ_FLAG_HIDDEN);
+    lv_canvas_set_buffer(scratch, scratch_buf, LAYER_NAME_WIDTH, LAYER_NAME_HEIGHT,
+                         LV_IMG_CF_TRUE_COLOR);
+
+    lv_draw_label_dsc_t label_dsc;
+    lv_draw_label_dsc_init(&label_dsc);
+    lv_obj_init_draw_label_dsc(parent, LV_PART_MAIN, &label_dsc);
+    label_dsc.color = lv_color_black();
+
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        if (!(layers & BIT(i))) {
+            continue;
+        }
 
-        snprintf(text, sizeof(text), "%s", state.label);
+        char *text = layer_name_texts[i];
+        format_layer_name(text, sizeof(layer_name_texts[i]), i, zmk_keymap_layer_name(i));
 
-        lv_label_set_text(label, text);
+        lv_canvas_fill_bg(scratch, lv_color_white(), LV_OPA_COVER);
+        lv_canvas_draw_text(scratch, 0, 0, LAYER_NAME_WIDTH, &label_dsc, text);
+        pack_layer_name_glyph(scratch, &layer_name_glyphs[i]);
+        lv_img_cache_invalidate_src(&layer_name_glyphs[i].dsc);
     }
+
+    lv_obj_del(scratch);
+    lv_mem_free(scratch_buf);
+
+    layer_name_glyphs_rendered = true;
 }
 
+static void set_layer_symbol(lv_obj_t *img, struct layer_status_state state) {
+    if (!layer_name_glyphs_rendered || state.index >= ZMK_KEYMAP_LAYERS_LEN) {
+        return;
+    }
+
+    const lv_img_dsc_t *src = &layer_name_glyphs[state.index].dsc;
+
+    // a name changed at runtime is rendered again the next time its layer is shown
+    char text[sizeof(layer_name_texts[0])] = {};
+    format_layer_name(text, sizeof(text), state.index, state.label);
+    if (strcmp(text, layer_name_texts[state.index]) != 0) {
+        render_layer_name_glyphs(lv_obj_get_parent(img), BIT(state.index));
+        if (lv_img_get_src(img) == src) {
+            lv_obj_invalidate(img);
+        }
+    }
+
+    if (lv_img_get_src(img) != src) {
+        lv_img_set_src(img, src);
+    }
+}
+#else
+static void set_layer_symbol(lv_obj_t *label, struct layer_status_state state) {
+    char text[13] = {};
+
+    format_layer_name(text, sizeof(text), state.index, state.label);
+
+    lv_label_set_text(label, text);
+}
+#endif
+
+DONGLE_BENCH_DEFINE(layer_update);
+DONGLE_BENCH_DEFINE(layer_listener);
+
 static void layer_status_update_cb(struct layer_status_state state) {
+    DONGLE_BENCH_BEGIN(layer_update);
     struct zmk_widget_layer_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->obj, state); }
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        set_layer_symbol(widget->name, state);
+        set_layer_stack(widget, state.layers);
+    }
+#else
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_layer_symbol(widget->name, state); }
+#endif
+    DONGLE_BENCH_END(layer_update);
 }
 
 static struct layer_status_state layer_status_get_state(const zmk_event_t *eh) {
+    DONGLE_BENCH_BEGIN(layer_listener);
     uint8_t index = zmk_keymap_highest_layer_active();
-    return (struct layer_status_state) {
+    struct layer_status_state state = {
         .index = index,
-        .label = zmk_keymap_layer_name(index)
+        .label = zmk_keymap_layer_name(index),
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+        .layers = zmk_keymap_layer_state(),
+#endif
     };
+    DONGLE_BENCH_END(layer_listener);
+    return state;
 }
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, layer_status_update_cb,
@@ -56,8 +225,44 @@ ZMK_DISPLAY_WIDGET_LISTENER(widget_layer_status, struct layer_status_state, laye
 
 ZMK_SUBSCRIPTION(widget_layer_status, zmk_layer_state_changed);
 
+static lv_obj_t *create_layer_name(lv_obj_t *parent) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_NAME_CACHE)
+    if (!layer_name_glyphs_rendered) {
+        render_layer_name_glyphs(parent, UINT32_MAX);
+    }
+    return lv_img_create(parent);
+#else
+    lv_obj_t *label = lv_label_create(parent);
+    lv_obj_set_width(label, LAYER_NAME_WIDTH);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+    return label;
+#endif
+}
+
 int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent) {
-    widget->obj = lv_label_create(parent);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+    widget->obj = lv_obj_create(parent);
+    lv_obj_set_size(widget->obj, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+
+    widget->name = create_layer_name(widget->obj);
+    lv_obj_align(widget->name, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    widget->stack = lv_canvas_create(widget->obj);
+    // transparent like the layer name glyphs, so the gaps between the blocks do not paint over
+    // what is under them
+    canvas_1bit_init(widget->stack, widget->stack_cbuf, LAYER_STACK_WIDTH, LAYER_STACK_HEIGHT,
+                     true);
+    lv_obj_align_to(widget->stack, widget->name, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 1);
+
+    // draw every block once, later updates only touch the layers that changed
+    widget->rendered_layers = 0;
+    for (int i = 0; i < LAYER_STACK_LAYERS; i++) {
+        draw_layer_block(widget, i, false);
+    }
+#else
+    widget->obj = create_layer_name(parent);
+    widget->name = widget->obj;
+#endif
 
     sys_slist_append(&widgets, &widget->node);
 
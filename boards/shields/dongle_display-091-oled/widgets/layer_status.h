@@ -8,10 +8,30 @@
 
 #include <lvgl.h>
 #include <zephyr/kernel.h>
+#include <zmk/keymap.h>
+
+#define LAYER_STACK_BLOCK_WIDTH 4
+#define LAYER_STACK_BLOCK_HEIGHT 3
+// Six columns keep the stack in the 30 px between the output status and the bongo cat, and two
+// rows keep it above the modifiers. Higher layers are not drawn.
+#define LAYER_STACK_COLUMNS 6
+#define LAYER_STACK_ROWS 2
+#define LAYER_STACK_MAX_LAYERS (LAYER_STACK_COLUMNS * LAYER_STACK_ROWS)
+#define LAYER_STACK_LAYERS MIN(ZMK_KEYMAP_LAYERS_LEN, LAYER_STACK_MAX_LAYERS)
+#define LAYER_STACK_WIDTH (MIN(LAYER_STACK_LAYERS, LAYER_STACK_COLUMNS) * (LAYER_STACK_BLOCK_WIDTH + 1))
+#define LAYER_STACK_HEIGHT                                                                         \
+    (DIV_ROUND_UP(LAYER_STACK_LAYERS, LAYER_STACK_COLUMNS) * (LAYER_STACK_BLOCK_HEIGHT + 1) - 1)
 
 struct zmk_widget_layer_status {
     sys_snode_t node;
     lv_obj_t *obj;
+    // label, or image of the cached layer name glyph; the same as obj without the layer stack
+    lv_obj_t *name;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LAYER_STACK)
+    lv_obj_t *stack;
+    zmk_keymap_layers_state_t rendered_layers;
+    uint8_t stack_cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(LAYER_STACK_WIDTH, LAYER_STACK_HEIGHT)];
+#endif
 };
 
 int zmk_widget_layer_status_init(struct zmk_widget_layer_status *widget, lv_obj_t *parent);
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "link_health.h"
+#include "link_health_format.h"
+#include "../stats/link_health.h"
+
+BUILD_ASSERT(LINK_HEALTH_RSSI_UNKNOWN == LINK_HEALTH_LINE_RSSI_UNKNOWN);
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// one line per peripheral: slot, interval in ms, average rssi and disconnect count
+static void set_link_health_text(lv_obj_t *label) {
+    char text[LINK_HEALTH_SLOTS * LINK_HEALTH_LINE_LEN + 1] = {};
+    size_t len = 0;
+
+    for (int i = 0; i < LINK_HEALTH_SLOTS; i++) {
+        struct link_health_stats stats;
+        link_health_get(i, &stats);
+
+        struct link_health_line line = {
+            .slot = i,
+            .connected = stats.connected,
+            .interval = stats.interval,
+            .rssi = link_health_rssi_avg(&stats),
+            .disconnects = stats.disconnects,
+        };
+        len = link_health_format_line(text, sizeof(text), len, &line);
+    }
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void zmk_widget_link_health_refresh(void) {
+    struct zmk_widget_link_health *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_link_health_text(widget->obj); }
+}
+
+int zmk_widget_link_health_init(struct zmk_widget_link_health *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    set_link_health_text(widget->obj);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_link_health_obj(struct zmk_widget_link_health *widget) {
+    return widget->obj;
+}
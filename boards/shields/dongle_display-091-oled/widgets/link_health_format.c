@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+
+#include "link_health_format.h"
+
+// kept free of Zephyr and LVGL so scripts/tests can check it on the host
+size_t link_health_format_line(char *text, size_t size, size_t len,
+                               const struct link_health_line *line) {
+    const char *sep = len > 0 ? "\n" : "";
+    int n;
+
+    if (size == 0 || len >= size - 1) {
+        return len;
+    }
+
+    if (!line->connected) {
+        n = snprintf(text + len, size - len, "%s%u --", sep, line->slot);
+    } else if (line->rssi == LINK_HEALTH_LINE_RSSI_UNKNOWN) {
+        n = snprintf(text + len, size - len, "%s%u %u.%u -- d%u", sep, line->slot,
+                     line->interval * 5 / 4, (line->interval * 125) % 100 / 10,
+                     (unsigned int)line->disconnects);
+    } else {
+        n = snprintf(text + len, size - len, "%s%u %u.%u %d d%u", sep, line->slot,
+                     line->interval * 5 / 4, (line->interval * 125) % 100 / 10, line->rssi,
+                     (unsigned int)line->disconnects);
+    }
+
+    if (n < 0) {
+        text[len] = '\0';
+        return len;
+    }
+
+    return len + n < size ? len + n : size - 1;
+}
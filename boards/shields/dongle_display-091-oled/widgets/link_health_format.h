@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// longest line: "\n255 4000.0 -127 d4294967295"
+#define LINK_HEALTH_LINE_LEN 28
+// no sample yet, or a controller that does not report RSSI; printed as "--"
+#define LINK_HEALTH_LINE_RSSI_UNKNOWN INT8_MIN
+
+struct link_health_line {
+    uint8_t slot;
+    bool connected;
+    // 1.25 ms units
+    uint16_t interval;
+    int8_t rssi;
+    uint32_t disconnects;
+};
+
+// Appends the line of one peripheral to text, which holds len characters of size. Lines after the
+// first start with a newline. Returns the new length, at most size - 1; nothing is appended once
+// text is full, so a too small buffer only cuts lines off.
+size_t link_health_format_line(char *text, size_t size, size_t len,
+                               const struct link_health_line *line);
@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <dt-bindings/zmk/modifiers.h>
 
 #include "modifiers.h"
+#include "../stats/bench.h"
 
 struct modifiers_state {    
     uint8_t modifiers;
@@ -97,15 +98,23 @@ static void set_modifiers(lv_obj_t *widget, struct modifiers_state state) {
     }
 }
 
+DONGLE_BENCH_DEFINE(mods_update);
+DONGLE_BENCH_DEFINE(mods_listener);
+
 void modifiers_update_cb(struct modifiers_state state) {
+    DONGLE_BENCH_BEGIN(mods_update);
     struct zmk_widget_modifiers *widget;
     SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_modifiers(widget->obj, state); }
+    DONGLE_BENCH_END(mods_update);
 }
 
 static struct modifiers_state modifiers_get_state(const zmk_event_t *eh) {
-    return (struct modifiers_state) {
+    DONGLE_BENCH_BEGIN(mods_listener);
+    struct modifiers_state state = {
         .modifiers = zmk_hid_get_explicit_mods()
     };
+    DONGLE_BENCH_END(mods_listener);
+    return state;
 }
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_modifiers, struct modifiers_state,
@@ -19,6 +19,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/endpoints.h>
 
 #include "output_status.h"
+#include "../stats/bench.h"
 
 static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
 
@@ -41,21 +42,39 @@ const lv_img_dsc_t *sym_num[] = {
     &sym_5,
 };
 
-enum output_symbol {
-    output_symbol_usb,
-    output_symbol_usb_hid_status,
-    output_symbol_bt,
-    output_symbol_bt_number,
-    output_symbol_bt_status,
-    output_symbol_selection_line
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+LV_IMG_DECLARE(sym_profile_open);
+LV_IMG_DECLARE(sym_profile_bonded);
+LV_IMG_DECLARE(sym_profile_connected);
+LV_IMG_DECLARE(sym_profile_open_active);
+LV_IMG_DECLARE(sym_profile_bonded_active);
+LV_IMG_DECLARE(sym_profile_connected_active);
+
+enum profile_cell_state {
+    profile_cell_state_open,
+    profile_cell_state_bonded,
+    profile_cell_state_connected
 };
 
-enum selection_line_state {
-    selection_line_state_usb,
-    selection_line_state_bt
-} current_selection_line_state;
+// indexed by [is_active][profile_cell_state]
+static const lv_img_dsc_t *profile_cell_syms[2][3] = {
+    {&sym_profile_open, &sym_profile_bonded, &sym_profile_connected},
+    {&sym_profile_open_active, &sym_profile_bonded_active, &sym_profile_connected_active},
+};
+#endif
+
+#define SELECTION_LINE_ANIM_END 1024
 
-lv_point_t selection_line_points[] = { {0, 0}, {13, 0} }; // will be replaced with lv_point_precise_t 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+#define PROFILE_CELL_WIDTH 5
+#define PROFILE_CELL_HEIGHT 7
+// the bt symbol is 14 pixels high, which leaves room for two rows of cells
+#define PROFILE_STRIP_COLUMNS DIV_ROUND_UP(ZMK_BLE_PROFILE_COUNT, 2)
+// spans the bt symbol and the cells
+#define SELECTION_LINE_BT_WIDTH (11 + PROFILE_STRIP_COLUMNS * (PROFILE_CELL_WIDTH + 1))
+#else
+#define SELECTION_LINE_BT_WIDTH 18
+#endif
 
 struct output_status_state {
     struct zmk_endpoint_instance selected_endpoint;
@@ -63,99 +82,148 @@ struct output_status_state {
     bool active_profile_connected;
     bool active_profile_bonded;
     bool usb_is_hid_ready;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+    uint8_t profile_states[ZMK_BLE_PROFILE_COUNT];
+#endif
 };
 
+DONGLE_BENCH_DEFINE(output_listener);
+
 static struct output_status_state get_state(const zmk_event_t *_eh) {
-    return (struct output_status_state){
+    DONGLE_BENCH_BEGIN(output_listener);
+    struct output_status_state state = {
         .selected_endpoint = zmk_endpoints_selected(),
         .active_profile_index = zmk_ble_active_profile_index(),
         .active_profile_connected = zmk_ble_active_profile_is_connected(),
         .active_profile_bonded = !zmk_ble_active_profile_is_open(),
         .usb_is_hid_ready = zmk_usb_is_hid_ready()
     };
-}
 
-static void anim_x_cb(void * var, int32_t v) {
-    lv_obj_set_x(var, v);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        if (zmk_ble_profile_is_open(i)) {
+            state.profile_states[i] = profile_cell_state_open;
+        } else if (zmk_ble_profile_is_connected(i)) {
+            state.profile_states[i] = profile_cell_state_connected;
+        } else {
+            state.profile_states[i] = profile_cell_state_bonded;
+        }
+    }
+#endif
+
+    DONGLE_BENCH_END(output_listener);
+    return state;
 }
 
-static void anim_size_cb(void * var, int32_t v) {
-    selection_line_points[1].x = v;
+DONGLE_BENCH_DEFINE(selection_anim);
+
+// x and width are driven by one animation so both change in the same refresh step
+static void selection_line_anim_cb(void *var, int32_t v) {
+    struct zmk_widget_output_status *widget = var;
+    struct selection_line_anim *anim = &widget->selection_line_anim;
+    lv_obj_t *line = widget->selection_line;
+
+    lv_coord_t x = anim->from_x + (anim->to_x - anim->from_x) * v / SELECTION_LINE_ANIM_END;
+    lv_coord_t width =
+        anim->from_width + (anim->to_width - anim->from_width) * v / SELECTION_LINE_ANIM_END;
+    // the overshoot path only applies to the position, the width stays between its end points
+    width = CLAMP(width, MIN(anim->from_width, anim->to_width), MAX(anim->from_width, anim->to_width));
+
+    if (x == lv_obj_get_x(line) && width == widget->selection_line_points[1].x) {
+        return;
+    }
+
+    // lv_line_set_points invalidates the old span and refreshes the size, which invalidates
+    // the new span; lv_obj_set_x does the same for the position change
+    DONGLE_BENCH_BEGIN(selection_anim);
+    widget->selection_line_points[1].x = width;
+    lv_line_set_points(line, widget->selection_line_points, 2);
+    lv_obj_set_x(line, x);
+    DONGLE_BENCH_END(selection_anim);
 }
 
-static void move_object_x(void *obj, int32_t from, int32_t to) {
+static void move_selection_line(struct zmk_widget_output_status *widget, lv_coord_t to_x,
+                                lv_coord_t to_width) {
+    widget->selection_line_anim = (struct selection_line_anim){
+        .from_x = lv_obj_get_x(widget->selection_line),
+        .to_x = to_x,
+        .from_width = widget->selection_line_points[1].x,
+        .to_width = to_width,
+    };
+
+    lv_anim_del(widget, selection_line_anim_cb);
+
     lv_anim_t a;
     lv_anim_init(&a);
-    lv_anim_set_var(&a, obj);
+    lv_anim_set_var(&a, widget);
     lv_anim_set_time(&a, 200); // will be replaced with lv_anim_set_duration
-    lv_anim_set_exec_cb(&a, anim_x_cb);
+    lv_anim_set_exec_cb(&a, selection_line_anim_cb);
     lv_anim_set_path_cb(&a, lv_anim_path_overshoot);
-    lv_anim_set_values(&a, from, to);
+    lv_anim_set_values(&a, 0, SELECTION_LINE_ANIM_END);
     lv_anim_start(&a);
 }
 
-static void change_size_object(void *obj, int32_t from, int32_t to) {
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, obj);
-    lv_anim_set_time(&a, 200); // will be replaced with lv_anim_set_duration
-    lv_anim_set_exec_cb(&a, anim_size_cb);
-    lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-    lv_anim_set_values(&a, from, to);
-    lv_anim_start(&a);
+// lv_img_set_src invalidates the image even if the source did not change
+static void set_img_src(lv_obj_t *img, const lv_img_dsc_t *src) {
+    if (lv_img_get_src(img) != src) {
+        lv_img_set_src(img, src);
+    }
 }
 
-static void set_status_symbol(lv_obj_t *widget, struct output_status_state state) {
-    lv_obj_t *usb = lv_obj_get_child(widget, output_symbol_usb);
-    lv_obj_t *usb_hid_status = lv_obj_get_child(widget, output_symbol_usb_hid_status);
-    lv_obj_t *bt = lv_obj_get_child(widget, output_symbol_bt);
-    lv_obj_t *bt_number = lv_obj_get_child(widget, output_symbol_bt_number);
-    lv_obj_t *bt_status = lv_obj_get_child(widget, output_symbol_bt_status);
-    lv_obj_t *selection_line = lv_obj_get_child(widget, output_symbol_selection_line);
-
+static void set_status_symbol(struct zmk_widget_output_status *widget, struct output_status_state state) {
     switch (state.selected_endpoint.transport) {
     case ZMK_TRANSPORT_USB:
-        if (current_selection_line_state != selection_line_state_usb) {
-            move_object_x(selection_line, lv_obj_get_x(bt) - 1, lv_obj_get_x(usb) - 1);
-            change_size_object(selection_line, 18, 11);
-            current_selection_line_state = selection_line_state_usb;
+        if (widget->selection_line_state != selection_line_state_usb) {
+            move_selection_line(widget, lv_obj_get_x(widget->usb) - 1, 11);
+            widget->selection_line_state = selection_line_state_usb;
         }
         break;
     case ZMK_TRANSPORT_BLE:
-        if (current_selection_line_state != selection_line_state_bt) {
-            move_object_x(selection_line, lv_obj_get_x(usb) - 1, lv_obj_get_x(bt) - 1);
-            change_size_object(selection_line, 11, 18);
-            current_selection_line_state = selection_line_state_bt;
+        if (widget->selection_line_state != selection_line_state_bt) {
+            move_selection_line(widget, lv_obj_get_x(widget->bt) - 1, SELECTION_LINE_BT_WIDTH);
+            widget->selection_line_state = selection_line_state_bt;
         }
         break;
     }
 
     if (state.usb_is_hid_ready) {
-        lv_img_set_src(usb_hid_status, &sym_ok);
+        set_img_src(widget->usb_hid_status, &sym_ok);
     } else {
-        lv_img_set_src(usb_hid_status, &sym_nok);
+        set_img_src(widget->usb_hid_status, &sym_nok);
     }
 
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+    // the glyphs are shared constants, so only cells whose state or selection changed are redrawn
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        bool is_active = i == state.active_profile_index;
+        set_img_src(widget->profile_cells[i], profile_cell_syms[is_active][state.profile_states[i]]);
+    }
+#else
     if (state.active_profile_index < (sizeof(sym_num) / sizeof(lv_img_dsc_t *))) {
-        lv_img_set_src(bt_number, sym_num[state.active_profile_index]);
+        set_img_src(widget->bt_number, sym_num[state.active_profile_index]);
     } else {
-        lv_img_set_src(bt_number, &sym_nok);
+        set_img_src(widget->bt_number, &sym_nok);
     }
     
     if (state.active_profile_bonded) {
         if (state.active_profile_connected) {
-            lv_img_set_src(bt_status, &sym_ok);
+            set_img_src(widget->bt_status, &sym_ok);
         } else {
-            lv_img_set_src(bt_status, &sym_nok);
+            set_img_src(widget->bt_status, &sym_nok);
         }
     } else {
-        lv_img_set_src(bt_status, &sym_open);
+        set_img_src(widget->bt_status, &sym_open);
     }
+#endif
 }
 
+DONGLE_BENCH_DEFINE(output_update);
+
 static void output_status_update_cb(struct output_status_state state) {
+    DONGLE_BENCH_BEGIN(output_update);
     struct zmk_widget_output_status *widget;
-    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget->obj, state); }
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_status_symbol(widget, state); }
+    DONGLE_BENCH_END(output_update);
 }
 
 ZMK_DISPLAY_WIDGET_LISTENER(widget_output_status, struct output_status_state,
@@ -172,19 +240,31 @@ int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_ob
     lv_obj_t *usb = lv_img_create(widget->obj);
     lv_obj_align(usb, LV_ALIGN_TOP_LEFT, 1, 4);
     lv_img_set_src(usb, &sym_usb);
+    widget->usb = usb;
 
-    lv_obj_t *usb_hid_status = lv_img_create(widget->obj);
-    lv_obj_align_to(usb_hid_status, usb, LV_ALIGN_BOTTOM_LEFT, 2, -7);
+    widget->usb_hid_status = lv_img_create(widget->obj);
+    lv_obj_align_to(widget->usb_hid_status, usb, LV_ALIGN_BOTTOM_LEFT, 2, -7);
 
     lv_obj_t *bt = lv_img_create(widget->obj);
     lv_obj_align_to(bt, usb, LV_ALIGN_OUT_RIGHT_TOP, 6, 0);
     lv_img_set_src(bt, &sym_bt);
+    widget->bt = bt;
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+    // two rows of cells next to the bt symbol, in place of the active profile number and status
+    for (int i = 0; i < ZMK_BLE_PROFILE_COUNT; i++) {
+        widget->profile_cells[i] = lv_img_create(widget->obj);
+        lv_obj_align_to(widget->profile_cells[i], bt, LV_ALIGN_OUT_RIGHT_TOP,
+                        2 + (i % PROFILE_STRIP_COLUMNS) * (PROFILE_CELL_WIDTH + 1),
+                        -1 + (i / PROFILE_STRIP_COLUMNS) * (PROFILE_CELL_HEIGHT + 1));
+    }
+#else
+    widget->bt_number = lv_img_create(widget->obj);
+    lv_obj_align_to(widget->bt_number, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 7);
 
-    lv_obj_t *bt_number = lv_img_create(widget->obj);
-    lv_obj_align_to(bt_number, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 7);
-
-    lv_obj_t *bt_status = lv_img_create(widget->obj);
-    lv_obj_align_to(bt_status, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 1);
+    widget->bt_status = lv_img_create(widget->obj);
+    lv_obj_align_to(widget->bt_status, bt, LV_ALIGN_OUT_RIGHT_TOP, 2, 1);
+#endif
     
     static lv_style_t style_line;
     lv_style_init(&style_line);
@@ -192,9 +272,13 @@ int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_ob
 
     lv_obj_t *selection_line;
     selection_line = lv_line_create(widget->obj);
-    lv_line_set_points(selection_line, selection_line_points, 2);
+    widget->selection_line_points[0] = (lv_point_t){0, 0};
+    widget->selection_line_points[1] = (lv_point_t){13, 0};
+    widget->selection_line_state = selection_line_state_usb;
+    lv_line_set_points(selection_line, widget->selection_line_points, 2);
     lv_obj_add_style(selection_line, &style_line, 0);
     lv_obj_align_to(selection_line, usb, LV_ALIGN_OUT_TOP_LEFT, 3, -1);
+    widget->selection_line = selection_line;
  
     sys_slist_append(&widgets, &widget->node);
 
@@ -8,10 +8,36 @@
 
 #include <lvgl.h>
 #include <zephyr/kernel.h>
+#include <zmk/ble.h>
+
+enum selection_line_state {
+    selection_line_state_usb,
+    selection_line_state_bt
+};
+
+struct selection_line_anim {
+    lv_coord_t from_x;
+    lv_coord_t to_x;
+    lv_coord_t from_width;
+    lv_coord_t to_width;
+};
 
 struct zmk_widget_output_status {
     sys_snode_t node;
     lv_obj_t *obj;
+    lv_obj_t *usb;
+    lv_obj_t *usb_hid_status;
+    lv_obj_t *bt;
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_BLE_PROFILE_STRIP)
+    lv_obj_t *profile_cells[ZMK_BLE_PROFILE_COUNT];
+#else
+    lv_obj_t *bt_number;
+    lv_obj_t *bt_status;
+#endif
+    lv_obj_t *selection_line;
+    lv_point_t selection_line_points[2]; // will be replaced with lv_point_precise_t
+    enum selection_line_state selection_line_state;
+    struct selection_line_anim selection_line_anim;
 };
 
 int zmk_widget_output_status_init(struct zmk_widget_output_status *widget, lv_obj_t *parent);
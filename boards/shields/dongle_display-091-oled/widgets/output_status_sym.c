@@ -229,3 +229,129 @@ const lv_img_dsc_t sym_usb = {
 
 
 
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN uint8_t sym_profile_open_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xa8, 0x00, 0x88, 0x00, 0xa8, 0x00, 0x00, 
+};
+
+const lv_img_dsc_t sym_profile_open = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_open_map,
+};
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED uint8_t sym_profile_bonded_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xf8, 0x88, 0x88, 0x88, 0xf8, 0x00, 0x00, 
+};
+
+const lv_img_dsc_t sym_profile_bonded = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_bonded_map,
+};
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED uint8_t sym_profile_connected_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0x00, 0x00, 
+};
+
+const lv_img_dsc_t sym_profile_connected = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_connected_map,
+};
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN_ACTIVE
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN_ACTIVE
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_OPEN_ACTIVE uint8_t sym_profile_open_active_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xa8, 0x00, 0x88, 0x00, 0xa8, 0x00, 0xf8, 
+};
+
+const lv_img_dsc_t sym_profile_open_active = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_open_active_map,
+};
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED_ACTIVE
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED_ACTIVE
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_BONDED_ACTIVE uint8_t sym_profile_bonded_active_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xf8, 0x88, 0x88, 0x88, 0xf8, 0x00, 0xf8, 
+};
+
+const lv_img_dsc_t sym_profile_bonded_active = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_bonded_active_map,
+};
+
+#ifndef LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED_ACTIVE
+#define LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED_ACTIVE
+#endif
+
+const LV_ATTRIBUTE_MEM_ALIGN LV_ATTRIBUTE_LARGE_CONST LV_ATTRIBUTE_IMG_SYM_PROFILE_CONNECTED_ACTIVE uint8_t sym_profile_connected_active_map[] = {
+  0xff, 0xff, 0xff, 0xff, 	/*Color of index 0*/
+  0x00, 0x00, 0x00, 0xff, 	/*Color of index 1*/
+
+  0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0x00, 0xf8, 
+};
+
+const lv_img_dsc_t sym_profile_connected_active = {
+  .header.cf = LV_IMG_CF_INDEXED_1BIT,
+  .header.always_zero = 0,
+  .header.reserved = 0,
+  .header.w = 5,
+  .header.h = 7,
+  .data_size = 15,
+  .data = sym_profile_connected_active_map,
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "split_jitter.h"
+#include "../stats/split_jitter.h"
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// one line per peripheral with p50/p99/max in ms, then the events reordered by combos and hold-taps
+static void set_split_jitter_text(lv_obj_t *label) {
+    char text[(ZMK_SPLIT_BLE_PERIPHERAL_COUNT + 1) * 16] = {};
+    int len = 0;
+
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT && len < sizeof(text); i++) {
+        struct split_jitter_summary summary;
+        split_jitter_get(i, &summary);
+
+        len += snprintf(text + len, sizeof(text) - len, "%d %u/%u/%u\n", i, summary.p50,
+                        summary.p99, summary.max);
+    }
+
+    if (len < sizeof(text)) {
+        snprintf(text + len, sizeof(text) - len, "inv %u", split_jitter_inversions());
+    }
+
+    if (strcmp(lv_label_get_text(label), text) != 0) {
+        lv_label_set_text(label, text);
+    }
+}
+
+void zmk_widget_split_jitter_refresh(void) {
+    struct zmk_widget_split_jitter *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { set_split_jitter_text(widget->obj); }
+}
+
+int zmk_widget_split_jitter_init(struct zmk_widget_split_jitter *widget, lv_obj_t *parent) {
+    widget->obj = lv_label_create(parent);
+    lv_obj_align(widget->obj, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    sys_slist_append(&widgets, &widget->node);
+
+    set_split_jitter_text(widget->obj);
+    return 0;
+}
+
+lv_obj_t *zmk_widget_split_jitter_obj(struct zmk_widget_split_jitter *widget) {
+    return widget->obj;
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+struct zmk_widget_split_jitter {
+    sys_snode_t node;
+    lv_obj_t *obj;
+};
+
+int zmk_widget_split_jitter_init(struct zmk_widget_split_jitter *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_split_jitter_obj(struct zmk_widget_split_jitter *widget);
+void zmk_widget_split_jitter_refresh(void);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include "glyphs.h"
+#include "telemetry.h"
+#include "../stats/telemetry.h"
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+#include "../stats/host_time.h"
+#endif
+
+#define TELEMETRY_STRIDE CANVAS_1BIT_STRIDE(TELEMETRY_WIDTH)
+
+struct field_layout {
+    uint8_t x;
+    uint8_t y;
+    uint8_t len;
+    const char *caption;
+};
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+// a fourth row for the drift of the host clock
+#define ROW(n) (1 + (n) * 8)
+#else
+#define ROW(n) (2 + (n) * 11)
+#endif
+
+// two columns of rows; captions are drawn once, values start 5 glyphs after them
+static const struct field_layout layout[TELEMETRY_FIELDS] = {
+    [TELEMETRY_CPU] = {0, ROW(0), 4, "CPU"},
+    [TELEMETRY_HEAP] = {64, ROW(0), 6, "HEAP"},
+    [TELEMETRY_STACK] = {0, ROW(1), 4, "STK"},
+    [TELEMETRY_HEAP_PEAK] = {64, ROW(1), 6, "PEAK"},
+    [TELEMETRY_DISPLAY_STACK] = {0, ROW(2), 6, "DSP"},
+    [TELEMETRY_UPTIME] = {64, ROW(2), 7, "UP"},
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+    [TELEMETRY_CLOCK_DRIFT] = {0, ROW(3), 6, "DRFT"},
+    [TELEMETRY_CLOCK_PPM] = {64, ROW(3), 5, "PPM"},
+#endif
+};
+
+#define VALUE_OFFSET (5 * GLYPH_PITCH)
+
+BUILD_ASSERT(64 + VALUE_OFFSET + TELEMETRY_FIELD_LEN * GLYPH_PITCH <= TELEMETRY_WIDTH,
+             "Telemetry fields do not fit the page");
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+static void blit_text(uint8_t *pixels, int x, int y, const char *text) {
+    for (; *text; text++, x += GLYPH_PITCH) {
+        glyph_blit(pixels, TELEMETRY_STRIDE, x, y, *text, 1);
+    }
+}
+
+// only the glyphs that differ from what is drawn are blitted and invalidated
+static void set_field(struct zmk_widget_telemetry *widget, enum telemetry_field field,
+                      const char *text) {
+    const struct field_layout *f = &layout[field];
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+    char *drawn = widget->drawn[field];
+    int first = -1, last = -1;
+
+    for (int i = 0; i < f->len; i++) {
+        char c = *text ? *text++ : ' ';
+        if (c == drawn[i]) {
+            continue;
+        }
+
+        glyph_blit(pixels, TELEMETRY_STRIDE, f->x + VALUE_OFFSET + i * GLYPH_PITCH, f->y, c, 1);
+        drawn[i] = c;
+        if (first < 0) {
+            first = i;
+        }
+        last = i;
+    }
+
+    if (first < 0) {
+        return;
+    }
+
+    lv_area_t area = {
+        .x1 = widget->obj->coords.x1 + f->x + VALUE_OFFSET + first * GLYPH_PITCH,
+        .y1 = widget->obj->coords.y1 + f->y,
+        .x2 = widget->obj->coords.x1 + f->x + VALUE_OFFSET + (last + 1) * GLYPH_PITCH - 1,
+        .y2 = widget->obj->coords.y1 + f->y + GLYPH_HEIGHT - 1,
+    };
+    lv_obj_invalidate_area(widget->obj, &area);
+}
+
+static void set_telemetry(struct zmk_widget_telemetry *widget,
+                          const struct telemetry_sample *sample, uint32_t uptime_minutes) {
+    char text[TELEMETRY_FIELD_LEN + 1];
+
+    snprintf(text, sizeof(text), "%3u%%", sample->display_cpu);
+    set_field(widget, TELEMETRY_CPU, text);
+    snprintf(text, sizeof(text), "%6u", MIN(sample->heap_used, 999999));
+    set_field(widget, TELEMETRY_HEAP, text);
+    snprintf(text, sizeof(text), "%3u%%", sample->stack_peak);
+    set_field(widget, TELEMETRY_STACK, text);
+    snprintf(text, sizeof(text), "%6u", MIN(sample->heap_peak, 999999));
+    set_field(widget, TELEMETRY_HEAP_PEAK, text);
+    snprintf(text, sizeof(text), "%6u", MIN(sample->display_stack_free, 999999));
+    set_field(widget, TELEMETRY_DISPLAY_STACK, text);
+    snprintf(text, sizeof(text), "%4u:%02u", MIN(uptime_minutes / 60, 9999), uptime_minutes % 60);
+    set_field(widget, TELEMETRY_UPTIME, text);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+// the drift needs two syncs from the host, until then both fields show a dash
+static void set_clock_drift(struct zmk_widget_telemetry *widget,
+                            const struct host_time_drift *drift) {
+    char offset[TELEMETRY_FIELD_LEN + 1] = "     -";
+    char ppm[TELEMETRY_FIELD_LEN + 1] = "    -";
+
+    if (drift->syncs > 1) {
+        snprintf(offset, sizeof(offset), "%6d", CLAMP(drift->offset_ms, -99999, 999999));
+        snprintf(ppm, sizeof(ppm), "%5d", CLAMP(drift->ppm, -9999, 99999));
+    }
+
+    set_field(widget, TELEMETRY_CLOCK_DRIFT, offset);
+    set_field(widget, TELEMETRY_CLOCK_PPM, ppm);
+}
+#endif
+
+void zmk_widget_telemetry_refresh(void) {
+    struct telemetry_sample sample;
+    uint32_t uptime_minutes = k_uptime_get() / (60 * MSEC_PER_SEC);
+
+    telemetry_get(&sample);
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+    struct host_time_drift drift;
+    host_time_get_drift(&drift);
+#endif
+
+    struct zmk_widget_telemetry *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) {
+        set_telemetry(widget, &sample, uptime_minutes);
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+        set_clock_drift(widget, &drift);
+#endif
+    }
+}
+
+int zmk_widget_telemetry_init(struct zmk_widget_telemetry *widget, lv_obj_t *parent) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+
+    widget->obj = lv_canvas_create(parent);
+    canvas_1bit_init(widget->obj, widget->cbuf, TELEMETRY_WIDTH, TELEMETRY_HEIGHT, false);
+
+    // the fields start out blank, the first refresh draws every value
+    for (int i = 0; i < TELEMETRY_FIELDS; i++) {
+        blit_text(pixels, layout[i].x, layout[i].y, layout[i].caption);
+        memset(widget->drawn[i], ' ', TELEMETRY_FIELD_LEN);
+    }
+
+    sys_slist_append(&widgets, &widget->node);
+
+    zmk_widget_telemetry_refresh();
+    return 0;
+}
+
+lv_obj_t *zmk_widget_telemetry_obj(struct zmk_widget_telemetry *widget) {
+    return widget->obj;
+}
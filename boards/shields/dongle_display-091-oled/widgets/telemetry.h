@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+#define TELEMETRY_WIDTH 128
+#define TELEMETRY_HEIGHT 32
+
+// the longest value shown, the uptime as hhhh:mm
+#define TELEMETRY_FIELD_LEN 7
+
+enum telemetry_field {
+    TELEMETRY_CPU,
+    TELEMETRY_HEAP,
+    TELEMETRY_STACK,
+    TELEMETRY_HEAP_PEAK,
+    TELEMETRY_DISPLAY_STACK,
+    TELEMETRY_UPTIME,
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_CLOCK)
+    TELEMETRY_CLOCK_DRIFT,
+    TELEMETRY_CLOCK_PPM,
+#endif
+    TELEMETRY_FIELDS,
+};
+
+struct zmk_widget_telemetry {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    uint8_t cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(TELEMETRY_WIDTH, TELEMETRY_HEIGHT)];
+    // characters currently drawn in each field
+    char drawn[TELEMETRY_FIELDS][TELEMETRY_FIELD_LEN];
+};
+
+int zmk_widget_telemetry_init(struct zmk_widget_telemetry *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_telemetry_obj(struct zmk_widget_telemetry *widget);
+void zmk_widget_telemetry_refresh(void);
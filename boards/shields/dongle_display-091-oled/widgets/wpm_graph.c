@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/display.h>
+#include <zmk/wpm.h>
+
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM)
+#include "../wpm_estimator.h"
+#endif
+
+#include "glyphs.h"
+#include "wpm_graph.h"
+#include "../stats/bench.h"
+
+#define GRAPH_STRIDE CANVAS_1BIT_STRIDE(WPM_GRAPH_WIDTH)
+
+static sys_slist_t widgets = SYS_SLIST_STATIC_INIT(&widgets);
+
+// Column x of the graph shows samples[x]. New samples overwrite the oldest one in place, like a
+// sweeping trace, and the column at head is kept blank as the seam between newest and oldest.
+static uint8_t samples[WPM_GRAPH_WIDTH];
+static uint8_t samples_head;
+
+static uint8_t get_wpm(void) {
+#if IS_ENABLED(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM)
+    return wpm_estimator_get();
+#else
+    return zmk_wpm_get_state();
+#endif
+}
+
+static int column_height(uint8_t wpm) {
+    int height = MIN(wpm, CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH_MAX) * WPM_GRAPH_HEIGHT /
+                 CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH_MAX;
+
+    // keep a baseline so an idle graph is still visible
+    return MAX(height, 1);
+}
+
+// height 0 clears the column
+static void draw_column(uint8_t *pixels, int x, int height) {
+    canvas_1bit_fill_rect(pixels, GRAPH_STRIDE, x, 0, 1, WPM_GRAPH_HEIGHT - height, false);
+    canvas_1bit_fill_rect(pixels, GRAPH_STRIDE, x, WPM_GRAPH_HEIGHT - height, 1, height, true);
+}
+
+static void invalidate_column(struct zmk_widget_wpm_graph *widget, int x) {
+    lv_area_t area = {
+        .x1 = widget->obj->coords.x1 + x,
+        .y1 = widget->obj->coords.y1,
+        .x2 = widget->obj->coords.x1 + x,
+        .y2 = widget->obj->coords.y1 + WPM_GRAPH_HEIGHT - 1,
+    };
+    lv_obj_invalidate_area(widget->obj, &area);
+}
+
+// x is the column of the new sample, seam the one after it
+static void add_sample(struct zmk_widget_wpm_graph *widget, uint8_t wpm, int x, int seam) {
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+
+    draw_column(pixels, x, column_height(wpm));
+    draw_column(pixels, seam, 0);
+
+    // the canvas buffer was changed behind LVGL's back, only these two columns need a refresh;
+    // they are apart when the seam wraps around to the left edge
+    invalidate_column(widget, x);
+    invalidate_column(widget, seam);
+}
+
+static void wpm_graph_sample_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(wpm_graph_sample_work, wpm_graph_sample_work_cb);
+
+DONGLE_BENCH_DEFINE(wpm_graph_update);
+
+static void wpm_graph_sample_work_cb(struct k_work *work) {
+    DONGLE_BENCH_BEGIN(wpm_graph_update);
+    uint8_t wpm = get_wpm();
+    int x = samples_head;
+
+    samples[x] = wpm;
+    samples_head = (samples_head + 1) % WPM_GRAPH_WIDTH;
+
+    struct zmk_widget_wpm_graph *widget;
+    SYS_SLIST_FOR_EACH_CONTAINER(&widgets, widget, node) { add_sample(widget, wpm, x, samples_head); }
+    DONGLE_BENCH_END(wpm_graph_update);
+
+    k_work_schedule_for_queue(zmk_display_work_q(), &wpm_graph_sample_work,
+                              K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH_INTERVAL_MS));
+}
+
+int zmk_widget_wpm_graph_init(struct zmk_widget_wpm_graph *widget, lv_obj_t *parent) {
+    widget->obj = lv_canvas_create(parent);
+    canvas_1bit_init(widget->obj, widget->cbuf, WPM_GRAPH_WIDTH, WPM_GRAPH_HEIGHT, false);
+
+    // start from the history collected so far, with the seam at the next column to be written
+    uint8_t *pixels = CANVAS_1BIT_PIXELS(widget->cbuf);
+    for (int x = 0; x < WPM_GRAPH_WIDTH; x++) {
+        if (x != samples_head) {
+            draw_column(pixels, x, column_height(samples[x]));
+        }
+    }
+
+    bool first = sys_slist_is_empty(&widgets);
+    sys_slist_append(&widgets, &widget->node);
+
+    if (first) {
+        k_work_schedule_for_queue(zmk_display_work_q(), &wpm_graph_sample_work,
+                                  K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_WPM_GRAPH_INTERVAL_MS));
+    }
+
+    return 0;
+}
+
+lv_obj_t *zmk_widget_wpm_graph_obj(struct zmk_widget_wpm_graph *widget) {
+    return widget->obj;
+}
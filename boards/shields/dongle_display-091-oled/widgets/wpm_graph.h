@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <zephyr/kernel.h>
+
+// same footprint as the bongo cat so it can take its place
+#define WPM_GRAPH_WIDTH 50
+#define WPM_GRAPH_HEIGHT 26
+
+struct zmk_widget_wpm_graph {
+    sys_snode_t node;
+    lv_obj_t *obj;
+    uint8_t cbuf[LV_CANVAS_BUF_SIZE_INDEXED_1BIT(WPM_GRAPH_WIDTH, WPM_GRAPH_HEIGHT)];
+};
+
+int zmk_widget_wpm_graph_init(struct zmk_widget_wpm_graph *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_wpm_graph_obj(struct zmk_widget_wpm_graph *widget);
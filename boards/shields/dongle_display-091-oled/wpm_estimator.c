@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+
+#include "wpm_estimator.h"
+#include "events/local_wpm_changed.h"
+
+// must be a power of two so the free running head can be masked
+#define KEY_RING_SIZE 64
+#define KEY_RING_MASK (KEY_RING_SIZE - 1)
+
+// rate is kept in Q8 fixed point
+#define WPM_FRACTION_BITS 8
+
+#define WINDOW_MS CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM_WINDOW_MS
+#define CHARS_PER_WORD 5
+
+// written only by the event listener, read by the estimator work; the head is published
+// after the timestamp so the reader never sees a slot before it is filled
+static uint32_t key_times[KEY_RING_SIZE];
+static atomic_t key_head;
+
+static uint32_t wpm_fp;
+static uint8_t current_wpm;
+
+static void estimate_work_cb(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(estimate_work, estimate_work_cb);
+
+static uint32_t keys_in_window(uint32_t now) {
+    atomic_val_t head = atomic_get(&key_head);
+    uint32_t count = 0;
+
+    for (atomic_val_t i = head - 1; head - i <= KEY_RING_SIZE && i >= 0; i--) {
+        if (now - key_times[i & KEY_RING_MASK] > WINDOW_MS) {
+            break;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+static void estimate_work_cb(struct k_work *work) {
+    uint32_t keys = keys_in_window(k_uptime_get_32());
+    // shifted before the division, so the fraction bits keep the part of a WPM each key is worth
+    uint32_t instant_fp = (((uint64_t)keys * MSEC_PER_SEC * 60) << WPM_FRACTION_BITS) /
+                          (WINDOW_MS * CHARS_PER_WORD);
+
+    // exponentially weighted: wpm += (instant - wpm) / 2^shift
+    int32_t delta = (int32_t)instant_fp - (int32_t)wpm_fp;
+    wpm_fp += delta >> CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM_SMOOTHING_SHIFT;
+    if (instant_fp == 0 && wpm_fp < BIT(WPM_FRACTION_BITS)) {
+        wpm_fp = 0;
+    }
+
+    uint8_t wpm = MIN((wpm_fp + BIT(WPM_FRACTION_BITS - 1)) >> WPM_FRACTION_BITS, UINT8_MAX);
+    if (wpm != current_wpm) {
+        current_wpm = wpm;
+        raise_zmk_local_wpm_changed((struct zmk_local_wpm_changed){.state = wpm});
+    }
+
+    // stop sampling once typing stopped and the estimate decayed to zero
+    if (wpm_fp > 0 || keys > 0) {
+        k_work_schedule(&estimate_work, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM_INTERVAL_MS));
+    }
+}
+
+static int wpm_estimator_listener(const zmk_event_t *eh) {
+    const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
+    if (ev == NULL || !ev->state) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    atomic_val_t head = atomic_get(&key_head);
+    key_times[head & KEY_RING_MASK] = k_uptime_get_32();
+    atomic_set(&key_head, head + 1);
+
+    if (!k_work_delayable_is_pending(&estimate_work)) {
+        k_work_schedule(&estimate_work, K_MSEC(CONFIG_ZMK_DONGLE_DISPLAY_LOCAL_WPM_INTERVAL_MS));
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(dongle_wpm_estimator, wpm_estimator_listener);
+ZMK_SUBSCRIPTION(dongle_wpm_estimator, zmk_keycode_state_changed);
+
+uint8_t wpm_estimator_get(void) { return current_wpm; }
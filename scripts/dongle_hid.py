@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""Push pixels to the dongle panel over its raw HID framebuffer interface.
+
+Build the dongle with CONFIG_ZMK_DONGLE_DISPLAY_RAW_HID=y. The interface is
+found among the /dev/hidraw* nodes by its vendor usage page; pass --device to
+pick one. A region has to be claimed before it can be drawn to:
+
+    scripts/dongle_hid.py claim 0 --x 96 --page 0 --width 32 --pages 4
+    scripts/dongle_hid.py push 0 logo.pbm
+    scripts/dongle_hid.py stream 0 frames/*.pbm --fps 20
+    scripts/dongle_hid.py release 0
+
+Images are binary PBM files (P4) with the size of the region, black pixels are
+lit. Each push is sent as raw, RLE or delta RLE data, whichever is smallest.
+"stream" does not wait for replies from the dongle and sends a full frame
+every --keyframe frames, so a lost report does not stay on the panel; "status"
+shows how many reports were dropped or arrived out of sequence.
+
+"time" sets the clock of a dongle built with CONFIG_ZMK_DONGLE_DISPLAY_CLOCK=y
+to the local time of this machine. Sending it again later shows the drift of
+the dongle on its telemetry page.
+"""
+
+import argparse
+import glob
+import os
+import select
+import struct
+import sys
+import time
+
+REPORT_SIZE = 64
+PAYLOAD_OFFSET = 8
+PAYLOAD_SIZE = REPORT_SIZE - PAYLOAD_OFFSET
+USAGE_PAGE_PREFIX = bytes([0x06, 0x60, 0xff, 0x09, 0x61])
+
+CMD_CLAIM = 0x01
+CMD_RELEASE = 0x02
+CMD_WRITE = 0x03
+CMD_STATUS = 0x04
+CMD_TIME = 0x05
+
+FLAG_ACK = 0x01
+FLAG_COMMIT = 0x02
+
+ENC_RAW = 0
+ENC_RLE = 1
+ENC_DELTA = 2
+
+REGION_ALL = 0xff
+
+
+def find_device():
+    for node in sorted(glob.glob('/sys/class/hidraw/hidraw*')):
+        try:
+            with open(os.path.join(node, 'device/report_descriptor'), 'rb') as f:
+                if f.read().startswith(USAGE_PAGE_PREFIX):
+                    return os.path.join('/dev', os.path.basename(node))
+        except OSError:
+            continue
+    sys.exit('no dongle raw HID interface found, is CONFIG_ZMK_DONGLE_DISPLAY_RAW_HID enabled?')
+
+
+class Dongle:
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR)
+        self.seq = 0
+
+    def send(self, cmd, flags, body=b''):
+        report = bytes([cmd, flags, self.seq]) + body
+        self.seq = (self.seq + 1) & 0xff
+        # hidraw wants the report id first, the interface has none
+        os.write(self.fd, b'\0' + report.ljust(REPORT_SIZE, b'\0'))
+        return report[2]
+
+    def reply(self, cmd, seq, timeout=1.0):
+        deadline = time.monotonic() + timeout
+        while True:
+            left = deadline - time.monotonic()
+            if left <= 0 or not select.select([self.fd], [], [], left)[0]:
+                sys.exit(f'no reply from the dongle to command {cmd:#04x}')
+            data = os.read(self.fd, REPORT_SIZE)
+            if data[0] == 0x80 | cmd and data[2] == seq:
+                return data
+
+    def call(self, cmd, body=b''):
+        data = self.reply(cmd, self.send(cmd, FLAG_ACK, body))
+        if data[1]:
+            sys.exit(f'dongle rejected command {cmd:#04x}: {os.strerror(data[1])}')
+        return data
+
+
+def rle(data):
+    """Yield (offset, count, value) for runs of at most 255 equal bytes."""
+    i = 0
+    while i < len(data):
+        n = 1
+        while i + n < len(data) and n < 255 and data[i + n] == data[i]:
+            n += 1
+        yield i, n, data[i]
+        i += n
+
+
+def rle_writes(data, skip_zero):
+    """Pack the runs of data into WRITE bodies; zero runs are left out of delta writes."""
+    writes, offset, payload = [], None, b''
+    for start, count, value in rle(data):
+        if skip_zero and value == 0:
+            if payload:
+                writes.append((offset, payload))
+            offset, payload = None, b''
+            continue
+        if offset is None:
+            offset = start
+        payload += bytes([count, value])
+        if len(payload) == PAYLOAD_SIZE:
+            writes.append((offset, payload))
+            offset, payload = None, b''
+    if payload:
+        writes.append((offset, payload))
+    return writes
+
+
+def encode(frame, previous, encoding):
+    """Return (encoding, [(offset, payload)]) for the smallest way to send the frame."""
+    candidates = {
+        'raw': (ENC_RAW, [(i, frame[i:i + PAYLOAD_SIZE])
+                          for i in range(0, len(frame), PAYLOAD_SIZE)]),
+        'rle': (ENC_RLE, rle_writes(frame, False)),
+    }
+    if previous is not None:
+        delta = bytes(a ^ b for a, b in zip(frame, previous))
+        candidates['delta'] = (ENC_DELTA, rle_writes(delta, True))
+
+    if encoding != 'auto':
+        if encoding not in candidates:
+            sys.exit('delta needs a previous frame')
+        return candidates[encoding]
+    return min(candidates.values(), key=lambda c: len(c[1]))
+
+
+def write_frame(dongle, region, frame, previous, encoding, ack):
+    enc, writes = encode(frame, previous, encoding)
+    flags = FLAG_ACK if ack else 0
+
+    if not writes:
+        # an unchanged delta frame still has to be committed
+        enc, writes = ENC_DELTA, [(0, b'')]
+
+    for i, (offset, payload) in enumerate(writes):
+        last = i == len(writes) - 1
+        body = struct.pack('<BBHB', region, enc, offset, len(payload)) + payload
+        seq = dongle.send(CMD_WRITE, flags | (FLAG_COMMIT if last else 0), body)
+        if ack:
+            data = dongle.reply(CMD_WRITE, seq)
+            if data[1]:
+                sys.exit(f'dongle rejected a write: {os.strerror(data[1])}')
+    return len(writes)
+
+
+def read_pbm(path):
+    """Convert a P4 image to panel pages: one byte per column, the top row in bit 0."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    fields, pos = [], 0
+    while len(fields) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    pos += 1
+
+    if fields[0] != b'P4':
+        sys.exit(f'{path}: not a binary PBM (P4) image')
+    w, h = int(fields[1]), int(fields[2])
+    if h % 8:
+        sys.exit(f'{path}: the height has to be a multiple of 8')
+    width, pages = w, h // 8
+
+    stride = (w + 7) // 8
+    bits = data[pos:pos + stride * h]
+    out = bytearray(width * pages)
+    for y in range(h):
+        for x in range(w):
+            if bits[y * stride + x // 8] & (0x80 >> (x % 8)):
+                out[(y // 8) * width + x] |= 1 << (y % 8)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--device', help='hidraw node of the dongle')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    sub.add_parser('status', help='show the dongle counters')
+    sub.add_parser('time', help='set the dongle clock to the local time')
+
+    p = sub.add_parser('claim', help='take over a region of the panel')
+    p.add_argument('region', type=int)
+    p.add_argument('--x', type=int, required=True)
+    p.add_argument('--page', type=int, required=True, help='first 8 pixel row')
+    p.add_argument('--width', type=int, required=True)
+    p.add_argument('--pages', type=int, required=True)
+
+    p = sub.add_parser('release', help='give a region back to the widgets')
+    p.add_argument('region', help='region number or "all"')
+
+    for name, help_text in (('push', 'draw one image'), ('stream', 'draw a sequence of images')):
+        p = sub.add_parser(name, help=help_text)
+        p.add_argument('region', type=int)
+        p.add_argument('images', nargs='+', help='P4 PBM images with the size of the region')
+        p.add_argument('--encoding', choices=('auto', 'raw', 'rle', 'delta'), default='auto')
+    p.add_argument('--fps', type=float, default=10)
+    p.add_argument('--keyframe', type=int, default=30, help='send a full frame this often')
+    p.add_argument('--loop', action='store_true', help='repeat until interrupted')
+
+    p = sub.add_parser('fill', help='set every byte of a region')
+    p.add_argument('region', type=int)
+    p.add_argument('size', type=int, help='region size in bytes, width times pages')
+    p.add_argument('value', type=lambda v: int(v, 0))
+
+    args = parser.parse_args()
+    dongle = Dongle(args.device or find_device())
+
+    if args.command == 'status':
+        data = dongle.call(CMD_STATUS)
+        names = ('received', 'dropped', 'sequence_gaps', 'errors', 'commits')
+        for name, value in zip(names, struct.unpack_from('<5I', data, 4)):
+            print(f'{name:<14} {value}')
+
+    elif args.command == 'time':
+        now = time.time()
+        utc_offset = time.localtime(now).tm_gmtoff // 60
+        dongle.call(CMD_TIME, b'\0' + struct.pack('<qh', int(now * 1000), utc_offset))
+
+    elif args.command == 'claim':
+        dongle.call(CMD_CLAIM, bytes([args.region, args.x, args.page, args.width, args.pages]))
+
+    elif args.command == 'release':
+        region = REGION_ALL if args.region == 'all' else int(args.region)
+        dongle.call(CMD_RELEASE, bytes([region]))
+
+    elif args.command == 'fill':
+        write_frame(dongle, args.region, bytes([args.value]) * args.size, None, 'rle', True)
+
+    else:
+        frames = [read_pbm(path) for path in args.images]
+
+        if args.command == 'push':
+            for frame in frames:
+                write_frame(dongle, args.region, frame, None, args.encoding, True)
+            return
+
+        period = 1 / args.fps
+        previous, count, reports = None, 0, 0
+        start = next_frame = time.monotonic()
+        try:
+            while True:
+                for frame in frames:
+                    keyframe = previous is None or count % args.keyframe == 0
+                    encoding = 'auto' if keyframe and args.encoding == 'delta' else args.encoding
+                    reports += write_frame(dongle, args.region, frame,
+                                           None if keyframe else previous, encoding, False)
+                    previous, count = frame, count + 1
+
+                    next_frame += period
+                    time.sleep(max(0, next_frame - time.monotonic()))
+                if not args.loop:
+                    break
+        except KeyboardInterrupt:
+            pass
+
+        elapsed = time.monotonic() - start
+        print(f'{count} frames in {elapsed:.1f}s, {reports} reports, '
+              f'{reports / max(count, 1):.1f} reports per frame')
+
+
+if __name__ == '__main__':
+    main()
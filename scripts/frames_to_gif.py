@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""Turn a "dongle frames dump" into an animated GIF with the flushed areas marked.
+
+Build the dongle with CONFIG_ZMK_DONGLE_DISPLAY_FRAME_CAPTURE=y, save the shell
+output of "dongle frames dump" to a file (any surrounding log lines are
+skipped) and run:
+
+    scripts/frames_to_gif.py dump.txt frames.gif
+
+Each frame shows the whole panel image after the flush. The area that was
+flushed is outlined in red, and a caption gives the sequence number, the
+uptime, the time since the previous flush and the size of the flushed area.
+Frames are shown for as long as the panel kept them, within --min-delay and
+--max-delay. Requires Pillow.
+"""
+
+import argparse
+import re
+import sys
+
+try:
+    from PIL import Image, ImageDraw
+except ImportError:
+    sys.exit('frames_to_gif.py needs Pillow: pip install pillow')
+
+HEADER_RE = re.compile(r'frames (\d+) (\d+) (\d+)\s*$')
+FRAME_RE = re.compile(r'frame (\d+) (\d+) (-?\d+) (-?\d+) (-?\d+) (-?\d+)\s*$')
+HEX_RE = re.compile(r'^([0-9a-f]+)\s*$')
+
+LIT = (255, 255, 255)
+DARK = (0, 0, 0)
+DIRTY = (255, 0, 0)
+CAPTION = (200, 200, 200)
+CAPTION_HEIGHT = 12
+
+
+def parse(lines):
+    """Yield the panel size once, then (seq, timestamp, dirty, pixels) per frame."""
+    width = height = None
+    frame = None
+    hex_data = ''
+
+    for line in lines:
+        # shell prompts and log prefixes may precede the payload
+        line = line.strip()
+        for regex in (HEADER_RE, FRAME_RE):
+            m = regex.search(line)
+            if m:
+                break
+
+        if m and m.re is HEADER_RE:
+            width, height = int(m[2]), int(m[3])
+            continue
+
+        if m and m.re is FRAME_RE:
+            frame = (int(m[1]), int(m[2]), tuple(int(v) for v in m.groups()[2:]))
+            hex_data = ''
+            continue
+
+        h = HEX_RE.match(line)
+        if frame is not None and h:
+            hex_data += h[1]
+            if len(hex_data) == width * height // 4:
+                yield width, height, (*frame, bytes.fromhex(hex_data))
+                frame = None
+
+
+def render(width, height, frame, prev_timestamp, scale):
+    seq, timestamp, (x1, y1, x2, y2), pixels = frame
+    stride = width // 8
+
+    img = Image.new('RGB', (width * scale, height * scale + CAPTION_HEIGHT), DARK)
+    draw = ImageDraw.Draw(img)
+
+    for y in range(height):
+        for x in range(width):
+            if pixels[y * stride + x // 8] & (0x80 >> (x % 8)):
+                draw.rectangle([x * scale, y * scale, (x + 1) * scale - 1, (y + 1) * scale - 1],
+                               fill=LIT)
+
+    draw.rectangle([x1 * scale, y1 * scale, (x2 + 1) * scale - 1, (y2 + 1) * scale - 1],
+                   outline=DIRTY)
+
+    delta = '' if prev_timestamp is None else f' +{timestamp - prev_timestamp}ms'
+    caption = (f'#{seq} {timestamp}ms{delta} '
+               f'[{x1},{y1} {x2 - x1 + 1}x{y2 - y1 + 1}]')
+    draw.text((2, height * scale + 1), caption, fill=CAPTION)
+
+    return img
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('dump', help='saved output of "dongle frames dump", or - for stdin')
+    parser.add_argument('gif', help='GIF file to write')
+    parser.add_argument('--scale', type=int, default=4, help='pixels per panel pixel')
+    parser.add_argument('--min-delay', type=int, default=40, help='shortest frame time in ms')
+    parser.add_argument('--max-delay', type=int, default=2000, help='longest frame time in ms')
+    args = parser.parse_args()
+
+    source = sys.stdin if args.dump == '-' else open(args.dump, encoding='utf-8', errors='replace')
+    with source:
+        parsed = list(parse(source))
+
+    if not parsed:
+        sys.exit('no frames found in the dump')
+
+    images, durations = [], []
+    prev_timestamp = None
+    for i, (width, height, frame) in enumerate(parsed):
+        images.append(render(width, height, frame, prev_timestamp, args.scale))
+        prev_timestamp = frame[1]
+
+        # a frame stays on the panel until the next flush
+        next_timestamp = parsed[i + 1][2][1] if i + 1 < len(parsed) else frame[1]
+        shown = next_timestamp - frame[1] if i + 1 < len(parsed) else args.max_delay
+        durations.append(max(args.min_delay, min(args.max_delay, shown)))
+
+    images[0].save(args.gif, save_all=True, append_images=images[1:], duration=durations,
+                   loop=0, optimize=False)
+    print(f'{len(images)} frames written to {args.gif}')
+
+
+if __name__ == '__main__':
+    main()
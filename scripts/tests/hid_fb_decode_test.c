@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host check of the raw HID write decoder and the region bookkeeping around it: a region inside a
+// panel sized buffer, so writes that land outside the region or partly apply a rejected report
+// show up as changed bytes.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hid_fb_decode.h"
+#include "hid_fb_regions.h"
+
+#define PANEL_WIDTH 128
+#define PANEL_PAGES 4
+#define GUARD 0xa5
+
+// region of 20 x 2 pages at x 10, page 1
+#define REGION_X 10
+#define REGION_PAGE 1
+#define REGION_WIDTH 20
+#define REGION_PAGES 2
+#define REGION_SIZE (REGION_WIDTH * REGION_PAGES)
+
+static int failures;
+
+#define CHECK(cond, ...)                                                                           \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);                                            \
+            printf(__VA_ARGS__);                                                                   \
+            printf("\n");                                                                          \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (0)
+
+static uint8_t staging[PANEL_PAGES][PANEL_WIDTH];
+static uint8_t shown[PANEL_PAGES][PANEL_WIDTH];
+
+static const struct hid_fb_view view = {
+    .staging = &staging[REGION_PAGE][REGION_X],
+    .shown = &shown[REGION_PAGE][REGION_X],
+    .pitch = PANEL_WIDTH,
+    .width = REGION_WIDTH,
+    .pages = REGION_PAGES,
+};
+
+static struct hid_fb_panel panel = {
+    .staging = &staging[0][0],
+    .shown = &shown[0][0],
+    .width = PANEL_WIDTH,
+    .pages = PANEL_PAGES,
+};
+
+static void reset(void) {
+    memset(staging, GUARD, sizeof(staging));
+    for (int p = 0; p < PANEL_PAGES; p++) {
+        for (int x = 0; x < PANEL_WIDTH; x++) {
+            shown[p][x] = (uint8_t)(p * PANEL_WIDTH + x);
+        }
+    }
+}
+
+static void reset_panel(void) {
+    reset();
+    memset(panel.regions, 0, sizeof(panel.regions));
+    memset(&panel.counters, 0, sizeof(panel.counters));
+    panel.last_seq = 0;
+}
+
+static int command(uint8_t cmd, uint8_t flags, uint8_t seq, uint8_t a, uint8_t b, uint8_t c,
+                   uint8_t d, uint8_t e) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {cmd, flags, seq, a, b, c, d, e};
+    struct hid_fb_region previous;
+    uint8_t released;
+    bool committed;
+
+    switch (cmd) {
+    case HID_FB_CMD_CLAIM:
+        return hid_fb_panel_claim(&panel, report, &previous);
+    case HID_FB_CMD_RELEASE:
+        return hid_fb_panel_release(&panel, report, &released);
+    default:
+        return hid_fb_panel_write(&panel, report, &committed);
+    }
+}
+
+static int claim(uint8_t id, uint8_t x, uint8_t page, uint8_t width, uint8_t pages) {
+    return command(HID_FB_CMD_CLAIM, 0, 0, id, x, page, width, pages);
+}
+
+static uint8_t *region_byte(int offset) {
+    return &staging[REGION_PAGE + offset / REGION_WIDTH][REGION_X + offset % REGION_WIDTH];
+}
+
+static int write(uint8_t encoding, uint16_t offset, const uint8_t *payload, uint8_t len) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {0x03, 0, 0, 0, encoding, offset & 0xff, offset >> 8, len};
+
+    memcpy(&report[8], payload, len < HID_FB_REPORT_SIZE - 8 ? len : HID_FB_REPORT_SIZE - 8);
+    return hid_fb_decode_write(&view, report);
+}
+
+// bytes outside the region are never written
+static void check_outside_untouched(const char *name) {
+    for (int p = 0; p < PANEL_PAGES; p++) {
+        for (int x = 0; x < PANEL_WIDTH; x++) {
+            bool inside = p >= REGION_PAGE && p < REGION_PAGE + REGION_PAGES && x >= REGION_X &&
+                          x < REGION_X + REGION_WIDTH;
+            if (!inside) {
+                CHECK(staging[p][x] == GUARD, "%s: byte %d,%d outside the region written", name, p,
+                      x);
+            }
+        }
+    }
+}
+
+static void check_unchanged(const char *name) {
+    for (int p = 0; p < PANEL_PAGES; p++) {
+        for (int x = 0; x < PANEL_WIDTH; x++) {
+            CHECK(staging[p][x] == GUARD, "%s: byte %d,%d written by a rejected report", name, p,
+                  x);
+        }
+    }
+}
+
+static void test_raw_across_pages(void) {
+    uint8_t payload[10];
+    for (int i = 0; i < 10; i++) {
+        payload[i] = i + 1;
+    }
+
+    reset();
+    CHECK(write(HID_FB_ENC_RAW, 15, payload, 10) == 0, "raw write rejected");
+    for (int i = 0; i < REGION_SIZE; i++) {
+        uint8_t expected = i >= 15 && i < 25 ? i - 14 : GUARD;
+        CHECK(*region_byte(i) == expected, "raw: region byte %d is %u, not %u", i,
+              *region_byte(i), expected);
+    }
+    check_outside_untouched("raw");
+}
+
+static void test_raw_to_the_end(void) {
+    uint8_t payload[6] = {1, 2, 3, 4, 5, 6};
+
+    reset();
+    CHECK(write(HID_FB_ENC_RAW, REGION_SIZE - 6, payload, 6) == 0, "raw write to the end rejected");
+    CHECK(*region_byte(REGION_SIZE - 1) == 6, "raw: last byte not written");
+    check_outside_untouched("raw to the end");
+
+    reset();
+    CHECK(write(HID_FB_ENC_RAW, REGION_SIZE - 5, payload, 6) == -EINVAL, "raw past the end accepted");
+    check_unchanged("raw past the end");
+}
+
+static void test_rle(void) {
+    uint8_t payload[] = {3, 0x11, 25, 0x22, 2, 0x33};
+
+    reset();
+    CHECK(write(HID_FB_ENC_RLE, 5, payload, sizeof(payload)) == 0, "rle write rejected");
+    for (int i = 0; i < REGION_SIZE; i++) {
+        uint8_t expected = i < 5 ? GUARD : i < 8 ? 0x11 : i < 33 ? 0x22 : i < 35 ? 0x33 : GUARD;
+        CHECK(*region_byte(i) == expected, "rle: region byte %d is %u, not %u", i,
+              *region_byte(i), expected);
+    }
+    check_outside_untouched("rle");
+}
+
+// the earlier runs fit, only the last one does not: nothing may be applied
+static void test_rejected_runs_leave_staging(void) {
+    uint8_t payload[] = {10, 0x11, 10, 0x22, 21, 0x33};
+
+    for (uint8_t encoding = HID_FB_ENC_RLE; encoding <= HID_FB_ENC_DELTA; encoding++) {
+        reset();
+        CHECK(write(encoding, 0, payload, sizeof(payload)) == -EINVAL,
+              "encoding %u: runs past the end accepted", encoding);
+        check_unchanged("runs past the end");
+    }
+
+    // run counts that only overflow a 16 bit sum
+    uint8_t big[56];
+    for (int i = 0; i < 56; i += 2) {
+        big[i] = 255;
+        big[i + 1] = 0x44;
+    }
+    reset();
+    CHECK(write(HID_FB_ENC_RLE, 0xffff, big, sizeof(big)) == -EINVAL, "wrapping runs accepted");
+    check_unchanged("wrapping runs");
+}
+
+static void test_delta(void) {
+    uint8_t payload[] = {4, 0xff};
+
+    reset();
+    CHECK(write(HID_FB_ENC_DELTA, 18, payload, sizeof(payload)) == 0, "delta write rejected");
+    for (int i = 18; i < 22; i++) {
+        uint8_t expected =
+            shown[REGION_PAGE + i / REGION_WIDTH][REGION_X + i % REGION_WIDTH] ^ 0xff;
+        CHECK(*region_byte(i) == expected, "delta: region byte %d is %u, not %u", i,
+              *region_byte(i), expected);
+    }
+    check_outside_untouched("delta");
+
+    // an unchanged frame is an empty delta, which is still a valid write
+    reset();
+    CHECK(write(HID_FB_ENC_DELTA, 0, payload, 0) == 0, "empty delta rejected");
+    check_unchanged("empty delta");
+}
+
+static void test_malformed(void) {
+    uint8_t payload[64] = {1, 1, 1};
+
+    reset();
+    CHECK(write(HID_FB_ENC_RLE, 0, payload, 3) == -EINVAL, "odd rle payload accepted");
+    CHECK(write(HID_FB_ENC_RAW, 0, payload, 57) == -EINVAL, "oversized payload accepted");
+    CHECK(write(7, 0, payload, 2) == -ENOTSUP, "unknown encoding accepted");
+    check_unchanged("malformed");
+}
+
+static void test_claim(void) {
+    reset_panel();
+    CHECK(claim(0, REGION_X, REGION_PAGE, REGION_WIDTH, REGION_PAGES) == 0, "claim rejected");
+    CHECK(panel.regions[0].claimed, "region not claimed");
+    for (int i = 0; i < REGION_SIZE; i++) {
+        int p = REGION_PAGE + i / REGION_WIDTH, x = REGION_X + i % REGION_WIDTH;
+        CHECK(staging[p][x] == 0 && shown[p][x] == 0, "claim: region byte %d not cleared", i);
+    }
+    check_outside_untouched("claim");
+    CHECK(shown[0][0] == 0 && shown[REGION_PAGE][REGION_X - 1] == REGION_PAGE * PANEL_WIDTH + 9,
+          "claim: shown cleared outside the region");
+
+    CHECK(claim(HID_FB_REGIONS, 0, 0, 1, 1) == -EINVAL, "region id out of range accepted");
+    CHECK(claim(1, 0, 0, 0, 1) == -EINVAL, "empty width accepted");
+    CHECK(claim(1, 0, 0, 1, 0) == -EINVAL, "empty height accepted");
+    CHECK(claim(1, PANEL_WIDTH - 4, 0, 5, 1) == -EINVAL, "region right of the panel accepted");
+    CHECK(claim(1, 0, PANEL_PAGES - 1, 1, 2) == -EINVAL, "region below the panel accepted");
+    CHECK(!panel.regions[1].claimed, "rejected claim left a region claimed");
+
+    // a claim moving a region hands back the old one, which LVGL has to redraw
+    uint8_t report[HID_FB_REPORT_SIZE] = {HID_FB_CMD_CLAIM, 0, 0, 0, 0, 0, 8, 1};
+    struct hid_fb_region previous;
+    CHECK(hid_fb_panel_claim(&panel, report, &previous) == 0, "re-claim rejected");
+    CHECK(previous.claimed && previous.x == REGION_X && previous.page == REGION_PAGE &&
+              previous.width == REGION_WIDTH && previous.pages == REGION_PAGES,
+          "re-claim did not return the old region");
+    struct hid_fb_area area = hid_fb_region_area(&previous);
+    CHECK(area.x1 == REGION_X && area.y1 == REGION_PAGE * 8 &&
+              area.x2 == REGION_X + REGION_WIDTH - 1 &&
+              area.y2 == (REGION_PAGE + REGION_PAGES) * 8 - 1,
+          "region area %d,%d %d,%d", (int)area.x1, (int)area.y1, (int)area.x2, (int)area.y2);
+}
+
+static void test_release(void) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {HID_FB_CMD_RELEASE, 0, 0, 2};
+    uint8_t released;
+
+    reset_panel();
+    claim(0, 0, 0, 8, 1);
+    claim(2, 8, 0, 8, 1);
+    claim(3, 16, 0, 8, 1);
+
+    CHECK(hid_fb_panel_release(&panel, report, &released) == 0, "release rejected");
+    CHECK(released == 1 << 2, "release of region 2 released 0x%x", released);
+    CHECK(panel.regions[2].width == 8, "released region lost its geometry");
+
+    // releasing again is fine, there is just nothing to redraw
+    CHECK(hid_fb_panel_release(&panel, report, &released) == 0 && released == 0,
+          "second release released 0x%x", released);
+
+    report[3] = HID_FB_REGION_ALL;
+    CHECK(hid_fb_panel_release(&panel, report, &released) == 0, "release of all rejected");
+    CHECK(released == ((1 << 0) | (1 << 3)), "release of all released 0x%x", released);
+
+    report[3] = HID_FB_REGIONS;
+    CHECK(hid_fb_panel_release(&panel, report, &released) == -EINVAL && released == 0,
+          "release of a region id out of range accepted");
+}
+
+static void test_write_and_commit(void) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {HID_FB_CMD_WRITE, 0, 0, 0, HID_FB_ENC_RLE, 0, 0, 2,
+                                          REGION_SIZE, 0x5a};
+    bool committed;
+
+    reset_panel();
+    CHECK(hid_fb_panel_write(&panel, report, &committed) == -EINVAL,
+          "write to an unclaimed region accepted");
+    check_unchanged("write to an unclaimed region");
+
+    claim(0, REGION_X, REGION_PAGE, REGION_WIDTH, REGION_PAGES);
+    CHECK(hid_fb_panel_write(&panel, report, &committed) == 0 && !committed,
+          "write without commit rejected or committed");
+    CHECK(*region_byte(0) == 0x5a && shown[REGION_PAGE][REGION_X] == 0,
+          "write without commit reached shown");
+    CHECK(panel.counters.commits == 0, "write without commit counted");
+
+    report[1] = HID_FB_FLAG_COMMIT;
+    report[9] = 0xc3;
+    CHECK(hid_fb_panel_write(&panel, report, &committed) == 0 && committed, "commit rejected");
+    CHECK(panel.counters.commits == 1, "commit not counted");
+    for (int p = 0; p < PANEL_PAGES; p++) {
+        for (int x = 0; x < PANEL_WIDTH; x++) {
+            bool inside = p >= REGION_PAGE && p < REGION_PAGE + REGION_PAGES && x >= REGION_X &&
+                          x < REGION_X + REGION_WIDTH;
+            uint8_t expected = inside ? 0xc3 : (uint8_t)(p * PANEL_WIDTH + x);
+            CHECK(shown[p][x] == expected, "commit: shown byte %d,%d is %u, not %u", p, x,
+                  shown[p][x], expected);
+        }
+    }
+
+    // a rejected write commits nothing
+    report[7] = 3;
+    CHECK(hid_fb_panel_write(&panel, report, &committed) == -EINVAL && !committed,
+          "malformed commit accepted");
+    CHECK(panel.counters.commits == 1, "rejected commit counted");
+}
+
+static void test_sequence_gaps(void) {
+    uint8_t report[HID_FB_REPORT_SIZE] = {HID_FB_CMD_STATUS};
+
+    reset_panel();
+    // the first report can carry any sequence number
+    report[2] = 200;
+    hid_fb_panel_receive(&panel, report);
+    CHECK(panel.counters.sequence_gaps == 0, "first report counted as a gap");
+
+    for (int seq = 201; seq < 256 + 10; seq++) {
+        report[2] = (uint8_t)seq;
+        hid_fb_panel_receive(&panel, report);
+    }
+    CHECK(panel.counters.sequence_gaps == 0, "wrap of the sequence number counted as a gap");
+
+    report[2] = 12;
+    hid_fb_panel_receive(&panel, report);
+    report[2] = 12;
+    hid_fb_panel_receive(&panel, report);
+    report[2] = 13;
+    hid_fb_panel_receive(&panel, report);
+    CHECK(panel.counters.sequence_gaps == 2, "%u gaps, not 2", panel.counters.sequence_gaps);
+    CHECK(panel.counters.received == 69, "%u received, not 69", panel.counters.received);
+}
+
+static void test_patch_flush(void) {
+    // what LVGL flushes, 32 x 2 pages from x 4, page 1
+    uint8_t buf[2][32];
+    struct hid_fb_area area = {.x1 = 4, .y1 = 8, .x2 = 35, .y2 = 23};
+
+    reset_panel();
+    claim(0, REGION_X, REGION_PAGE, REGION_WIDTH, REGION_PAGES);
+    // sticks out of the flush on the right and at the bottom
+    claim(1, 30, 2, 20, 2);
+    // claimed then released, must not be patched
+    claim(2, 4, 1, 4, 1);
+    command(HID_FB_CMD_RELEASE, 0, 0, 2, 0, 0, 0, 0);
+    for (int p = 0; p < PANEL_PAGES; p++) {
+        for (int x = 0; x < PANEL_WIDTH; x++) {
+            shown[p][x] = (uint8_t)(0x80 | x);
+        }
+    }
+
+    memset(buf, GUARD, sizeof(buf));
+    hid_fb_panel_patch_flush(&panel, &area, &buf[0][0]);
+    for (int p = 0; p < 2; p++) {
+        for (int i = 0; i < 32; i++) {
+            int x = area.x1 + i, page = p + 1;
+            bool in0 = x >= REGION_X && x < REGION_X + REGION_WIDTH;
+            bool in1 = x >= 30 && page == 2;
+            uint8_t expected = in0 || in1 ? (uint8_t)(0x80 | x) : GUARD;
+            CHECK(buf[p][i] == expected, "patch: flush byte %d,%d is %u, not %u", p, i, buf[p][i],
+                  expected);
+        }
+    }
+
+    // LVGL only flushes whole pages, anything else is left alone
+    area.y1 = 9;
+    memset(buf, GUARD, sizeof(buf));
+    hid_fb_panel_patch_flush(&panel, &area, &buf[0][0]);
+    for (int i = 0; i < 64; i++) {
+        CHECK((&buf[0][0])[i] == GUARD, "patch of an unaligned flush wrote byte %d", i);
+    }
+}
+
+int main(void) {
+    test_raw_across_pages();
+    test_raw_to_the_end();
+    test_rle();
+    test_rejected_runs_leave_staging();
+    test_delta();
+    test_malformed();
+    test_claim();
+    test_release();
+    test_write_and_commit();
+    test_sequence_gaps();
+    test_patch_flush();
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("hid fb decode and regions: ok\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host check of the link health page text: simulated peripherals at the extremes of what the
+// controller reports, in buffers of the size the widget uses and smaller.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "link_health_format.h"
+
+#define GUARD 0xa5
+#define MAX_SLOTS 5
+
+static int failures;
+
+#define CHECK(cond, ...)                                                                           \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);                                            \
+            printf(__VA_ARGS__);                                                                   \
+            printf("\n");                                                                          \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (0)
+
+static const struct link_health_line worst = {
+    .slot = 255, .connected = true, .interval = 3200, .rssi = -127, .disconnects = UINT32_MAX};
+
+static size_t format_all(char *text, size_t size, const struct link_health_line *lines, int count) {
+    size_t len = 0;
+    for (int i = 0; i < count; i++) {
+        len = link_health_format_line(text, size, len, &lines[i]);
+    }
+    return len;
+}
+
+static void test_worst_case_line_fits(void) {
+    char text[LINK_HEALTH_LINE_LEN + 1];
+    size_t len = link_health_format_line(text, sizeof(text), 0, &worst);
+
+    CHECK(strcmp(text, "255 4000.0 -127 d4294967295") == 0, "got \"%s\"", text);
+    CHECK(len == strlen(text), "length %zu for \"%s\"", len, text);
+}
+
+static void test_lines(void) {
+    struct link_health_line lines[] = {
+        {.slot = 0, .connected = true, .interval = 6, .rssi = -52, .disconnects = 0},
+        {.slot = 1, .connected = false},
+        {.slot = 2, .connected = true, .interval = 9, .rssi = -7, .disconnects = 3},
+    };
+    char text[3 * LINK_HEALTH_LINE_LEN + 1];
+    size_t len = format_all(text, sizeof(text), lines, 3);
+
+    CHECK(strcmp(text, "0 7.5 -52 d0\n1 --\n2 11.2 -7 d3") == 0, "got \"%s\"", text);
+    CHECK(len == strlen(text), "length %zu for \"%s\"", len, text);
+}
+
+// connected before the first RSSI sample, or to a controller that rejects Read RSSI
+static void test_unknown_rssi(void) {
+    struct link_health_line line = {.slot = 1,
+                                    .connected = true,
+                                    .interval = 6,
+                                    .rssi = LINK_HEALTH_LINE_RSSI_UNKNOWN,
+                                    .disconnects = 2};
+    char text[LINK_HEALTH_LINE_LEN + 1];
+    size_t len = link_health_format_line(text, sizeof(text), 0, &line);
+
+    CHECK(strcmp(text, "1 7.5 -- d2") == 0, "got \"%s\"", text);
+    CHECK(len == strlen(text), "length %zu for \"%s\"", len, text);
+}
+
+// every peripheral at its worst, and the same into smaller buffers, never writes past the end
+static void test_no_overflow(void) {
+    struct link_health_line lines[MAX_SLOTS];
+    for (int i = 0; i < MAX_SLOTS; i++) {
+        lines[i] = worst;
+    }
+
+    for (int slots = 1; slots <= MAX_SLOTS; slots++) {
+        size_t full = slots * LINK_HEALTH_LINE_LEN + 1;
+
+        for (size_t size = 0; size <= full; size++) {
+            uint8_t buf[MAX_SLOTS * LINK_HEALTH_LINE_LEN + 1 + 16];
+            memset(buf, GUARD, sizeof(buf));
+            if (size > 0) {
+                buf[0] = '\0';
+            }
+
+            size_t len = format_all((char *)buf, size, lines, slots);
+
+            for (size_t i = size; i < sizeof(buf); i++) {
+                CHECK(buf[i] == GUARD, "%d slots, size %zu: byte %zu overwritten", slots, size, i);
+            }
+            if (size > 0) {
+                CHECK(len < size && strlen((char *)buf) == len,
+                      "%d slots, size %zu: length %zu", slots, size, len);
+            }
+            // the first line has no newline, so the widget buffer has a byte to spare
+            if (size == full) {
+                CHECK(len == full - 2, "%d slots: worst case cut to %zu of %zu", slots, len,
+                      full - 2);
+            }
+        }
+    }
+}
+
+int main(void) {
+    test_worst_case_line_fits();
+    test_lines();
+    test_unknown_rssi();
+    test_no_overflow();
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("link health format: ok\n");
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host check of the link health bookkeeping: peripherals connecting, dropping and coming back in
+// a table of fewer slots than peripherals, and the RSSI ring, built with 4 samples by the Makefile.
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "link_health_state.h"
+
+#define SLOTS 2
+
+static int failures;
+
+#define CHECK(cond, ...)                                                                           \
+    do {                                                                                           \
+        if (!(cond)) {                                                                             \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);                                            \
+            printf(__VA_ARGS__);                                                                   \
+            printf("\n");                                                                          \
+            failures++;                                                                            \
+        }                                                                                          \
+    } while (0)
+
+// random static addresses, differing only in the last byte
+static const uint8_t left[LINK_HEALTH_ADDR_LEN] = {1, 0xc0, 0x11, 0x22, 0x33, 0x44, 0x01};
+static const uint8_t right[LINK_HEALTH_ADDR_LEN] = {1, 0xc0, 0x11, 0x22, 0x33, 0x44, 0x02};
+static const uint8_t third[LINK_HEALTH_ADDR_LEN] = {1, 0xc0, 0x11, 0x22, 0x33, 0x44, 0x03};
+
+static struct link_health_stats slots[SLOTS];
+
+static void test_slots(void) {
+    memset(slots, 0, sizeof(slots));
+
+    CHECK(link_health_find_slot(slots, SLOTS, left, false) == -ENOENT,
+          "unknown peripheral found");
+    CHECK(!slots[0].in_use, "lookup without allocate took a slot");
+
+    // slots go in the order of the first connection and stay with their peripheral
+    CHECK(link_health_find_slot(slots, SLOTS, right, true) == 0, "first peripheral not in slot 0");
+    CHECK(link_health_find_slot(slots, SLOTS, left, true) == 1, "second peripheral not in slot 1");
+    CHECK(link_health_find_slot(slots, SLOTS, right, true) == 0, "known peripheral moved");
+    CHECK(link_health_find_slot(slots, SLOTS, left, false) == 1, "known peripheral not found");
+    CHECK(memcmp(slots[1].addr, left, LINK_HEALTH_ADDR_LEN) == 0, "slot address not kept");
+
+    CHECK(link_health_find_slot(slots, SLOTS, third, true) == -ENOMEM, "full table took a third");
+    CHECK(link_health_find_slot(slots, SLOTS, third, false) == -ENOENT,
+          "third peripheral found in a full table");
+}
+
+static void test_connection_events(void) {
+    struct link_health_stats stats = {0};
+
+    link_health_on_connected(&stats, 6, 0, 400);
+    CHECK(stats.connected && stats.connects == 1, "connect not recorded");
+    CHECK(stats.interval == 6 && stats.latency == 0 && stats.timeout == 400,
+          "connect parameters %u %u %u", stats.interval, stats.latency, stats.timeout);
+
+    link_health_on_param_updated(&stats, 12, 4, 200);
+    CHECK(stats.param_updates == 1 && stats.interval == 12 && stats.latency == 4 &&
+              stats.timeout == 200,
+          "parameter update not recorded");
+
+    // 0x08 is a supervision timeout, the usual reason of a link lost to range
+    link_health_on_disconnected(&stats, 0x08);
+    CHECK(!stats.connected && stats.disconnects == 1 && stats.last_disconnect_reason == 0x08,
+          "disconnect not recorded");
+    CHECK(stats.interval == 12, "disconnect forgot the last parameters");
+
+    // a reconnect counts, the last reason stays until the next disconnect
+    link_health_on_connected(&stats, 6, 0, 400);
+    CHECK(stats.connected && stats.connects == 2 && stats.last_disconnect_reason == 0x08,
+          "reconnect not recorded");
+    link_health_on_disconnected(&stats, 0x13);
+    CHECK(stats.disconnects == 2 && stats.last_disconnect_reason == 0x13,
+          "second disconnect reason 0x%02x", stats.last_disconnect_reason);
+    CHECK(stats.param_updates == 1, "reconnects counted as parameter updates");
+}
+
+static void test_rssi(void) {
+    struct link_health_stats stats = {0};
+
+    CHECK(link_health_rssi_last(&stats) == LINK_HEALTH_RSSI_UNKNOWN, "rssi of no samples known");
+    CHECK(link_health_rssi_avg(&stats) == LINK_HEALTH_RSSI_UNKNOWN, "average of no samples known");
+
+    link_health_add_rssi(&stats, -40);
+    link_health_add_rssi(&stats, -60);
+    CHECK(link_health_rssi_last(&stats) == -60, "last rssi %d", link_health_rssi_last(&stats));
+    CHECK(link_health_rssi_avg(&stats) == -50, "average %d of 2", link_health_rssi_avg(&stats));
+
+    // 4 samples kept: the ring wraps and the average only covers the newest
+    link_health_add_rssi(&stats, -60);
+    link_health_add_rssi(&stats, -60);
+    link_health_add_rssi(&stats, -80);
+    CHECK(stats.rssi_count == LINK_HEALTH_RSSI_SAMPLES, "%u samples counted", stats.rssi_count);
+    CHECK(link_health_rssi_last(&stats) == -80, "last rssi %d after the wrap",
+          link_health_rssi_last(&stats));
+    CHECK(link_health_rssi_avg(&stats) == -65, "average %d after the wrap",
+          link_health_rssi_avg(&stats));
+
+    // the extremes the controller reports do not overflow the sum
+    for (int i = 0; i < LINK_HEALTH_RSSI_SAMPLES; i++) {
+        link_health_add_rssi(&stats, -127);
+    }
+    CHECK(link_health_rssi_avg(&stats) == -127, "average %d of -127 dBm",
+          link_health_rssi_avg(&stats));
+}
+
+int main(void) {
+    test_slots();
+    test_connection_events();
+    test_rssi();
+
+    if (failures) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("link health state: ok\n");
+    return 0;
+}
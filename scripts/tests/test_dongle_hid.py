@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""Round trip check of the dongle_hid.py encoder against the dongle decoder.
+
+The write reports built by write_frame() are decoded by hid_fb_decode.c, the
+decoder the firmware runs, built as build/libhid_fb_decode.so. Run with
+"make -C scripts/tests", which builds the library first.
+"""
+
+import ctypes
+import errno
+import os
+import random
+import struct
+import sys
+import unittest
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, os.path.join(HERE, '..'))
+import dongle_hid as hid  # noqa: E402
+
+EINVAL = errno.EINVAL
+ENOTSUP = errno.ENOTSUP
+
+
+class View(ctypes.Structure):
+    """struct hid_fb_view"""
+    _fields_ = [
+        ('staging', ctypes.POINTER(ctypes.c_uint8)),
+        ('shown', ctypes.POINTER(ctypes.c_uint8)),
+        ('pitch', ctypes.c_uint16),
+        ('width', ctypes.c_uint16),
+        ('pages', ctypes.c_uint16),
+    ]
+
+
+decoder = ctypes.CDLL(os.path.join(HERE, 'build', 'libhid_fb_decode.so'))
+decoder.hid_fb_decode_write.argtypes = [ctypes.POINTER(View), ctypes.c_char_p]
+decoder.hid_fb_decode_write.restype = ctypes.c_int
+
+
+class DongleModel:
+    """One claimed region of the dongle, a single page row of size bytes.
+
+    Writes go through the firmware decoder; commits copy staging to shown like
+    hid_fb_panel_write() in hid_fb_regions.c.
+    """
+
+    def __init__(self, size):
+        self.size = size
+        self.staging_buf = (ctypes.c_uint8 * size)()
+        self.shown_buf = (ctypes.c_uint8 * size)()
+        self.view = View(self.staging_buf, self.shown_buf, size, size, 1)
+        self.commits = 0
+
+    @property
+    def staging(self):
+        return bytes(self.staging_buf)
+
+    @property
+    def shown(self):
+        return bytes(self.shown_buf)
+
+    def handle(self, report):
+        assert len(report) == hid.REPORT_SIZE, 'reports are always padded to 64 bytes'
+        if report[0] != hid.CMD_WRITE:
+            return ENOTSUP
+
+        # negative errno, replies carry it positive
+        status = -decoder.hid_fb_decode_write(ctypes.byref(self.view), report)
+        if status:
+            return status
+
+        if report[1] & hid.FLAG_COMMIT:
+            ctypes.memmove(self.shown_buf, self.staging_buf, self.size)
+            self.commits += 1
+        return 0
+
+
+class LoopbackDongle(hid.Dongle):
+    """Dongle that hands every report to the model instead of a hidraw node."""
+
+    def __init__(self, model):
+        self.model = model
+        self.seq = 0
+        self.reports = []
+        self.errors = []
+
+    def send(self, cmd, flags, body=b''):
+        report = (bytes([cmd, flags, self.seq]) + body).ljust(hid.REPORT_SIZE, b'\0')
+        self.seq = (self.seq + 1) & 0xff
+        assert len(report) == hid.REPORT_SIZE, f'report of {len(report)} bytes'
+        self.reports.append(report)
+        status = self.model.handle(report)
+        if status:
+            self.errors.append(status)
+        return report[2]
+
+    def reply(self, cmd, seq, timeout=1.0):
+        status = self.errors[-1] if self.errors else 0
+        return bytes([0x80 | cmd, status, seq]).ljust(hid.REPORT_SIZE, b'\0')
+
+
+def push(frames, encoding='auto', ack=False):
+    """Stream frames through the encoder into a fresh model; return the model and dongle."""
+    model = DongleModel(len(frames[0]))
+    dongle = LoopbackDongle(model)
+    previous = None
+    for frame in frames:
+        enc = encoding
+        if enc == 'delta' and previous is None:
+            enc = 'auto'
+        hid.write_frame(dongle, 0, frame, previous, enc, ack)
+        previous = frame
+    return model, dongle
+
+
+def random_frame(rng, size, density):
+    return bytes(rng.choice((0, 0xff, rng.randrange(256))) if rng.random() < density else 0
+                 for _ in range(size))
+
+
+class RoundTrip(unittest.TestCase):
+    SIZES = (1, 2, 55, 56, 57, 112, 255, 256, 257, 510, 511, 512)
+
+    def check(self, frames, encoding):
+        model, dongle = push(frames, encoding)
+        self.assertEqual(dongle.errors, [])
+        self.assertEqual(bytes(model.shown), frames[-1])
+        self.assertEqual(model.commits, len(frames))
+        for report in dongle.reports:
+            self.assertLessEqual(report[7], hid.PAYLOAD_SIZE)
+        return dongle
+
+    def test_raw(self):
+        rng = random.Random(1)
+        for size in self.SIZES:
+            with self.subTest(size=size):
+                self.check([random_frame(rng, size, 0.7)], 'raw')
+
+    def test_rle(self):
+        rng = random.Random(2)
+        for size in self.SIZES:
+            for density in (0.0, 0.1, 1.0):
+                with self.subTest(size=size, density=density):
+                    self.check([random_frame(rng, size, density)], 'rle')
+
+    def test_delta(self):
+        rng = random.Random(3)
+        for size in self.SIZES:
+            with self.subTest(size=size):
+                frames = [random_frame(rng, size, d) for d in (0.5, 0.05, 0.0, 1.0)]
+                frames.append(frames[-1])
+                self.check(frames, 'delta')
+
+    def test_auto_picks_fewest_reports(self):
+        rng = random.Random(4)
+        frame = random_frame(rng, 512, 0.02)
+        counts = {enc: len(hid.encode(frame, None, enc)[1]) for enc in ('raw', 'rle')}
+        self.assertEqual(len(hid.encode(frame, None, 'auto')[1]), min(counts.values()))
+        self.check([frame], 'auto')
+
+    def test_runs_at_the_count_limit(self):
+        for size in (254, 255, 256, 510, 511, 512):
+            for value in (0, 0x5a):
+                with self.subTest(size=size, value=value):
+                    dongle = self.check([bytes([value]) * size], 'rle')
+                    counts = [r[8 + i] for r in dongle.reports for i in range(0, r[7], 2)]
+                    self.assertTrue(all(0 < c <= 255 for c in counts), counts)
+
+    def test_payload_fills_a_report(self):
+        # alternating bytes are runs of one, 28 pairs per report
+        frame = bytes(i % 2 for i in range(hid.PAYLOAD_SIZE // 2 * 3 + 1))
+        dongle = self.check([frame], 'rle')
+        self.assertEqual([r[7] for r in dongle.reports], [56, 56, 56, 2])
+        self.assertEqual([struct.unpack_from('<H', r, 5)[0] for r in dongle.reports],
+                         [0, 28, 56, 84])
+
+    def test_unchanged_delta_still_commits(self):
+        frame = bytes(range(64))
+        dongle = self.check([frame, frame], 'delta')
+        last = dongle.reports[-1]
+        self.assertEqual((last[4], last[7]), (hid.ENC_DELTA, 0))
+        self.assertTrue(last[1] & hid.FLAG_COMMIT)
+
+    def test_delta_only_sends_changes(self):
+        base = bytes(512)
+        changed = bytearray(base)
+        changed[300:303] = b'\x01\x02\x03'
+        _, dongle = push([base, bytes(changed)], 'delta')
+        delta_reports = dongle.reports[-1:]
+        self.assertEqual(struct.unpack_from('<H', delta_reports[0], 5)[0], 300)
+        self.assertEqual(delta_reports[0][7], 6)
+
+    def test_acked_writes(self):
+        model, dongle = push([bytes(range(200)), bytes(200)], 'auto', ack=True)
+        self.assertEqual(bytes(model.shown), bytes(200))
+        self.assertTrue(all(r[1] & hid.FLAG_ACK for r in dongle.reports))
+
+
+class DecoderRejects(unittest.TestCase):
+    """The decoder refuses writes that do not fit the region and leaves staging alone."""
+
+    def write(self, size, encoding, offset, payload, flags=hid.FLAG_COMMIT):
+        model = DongleModel(size)
+        body = struct.pack('<BBHB', 0, encoding, offset, len(payload)) + payload
+        report = (bytes([hid.CMD_WRITE, flags, 0]) + body).ljust(hid.REPORT_SIZE, b'\0')
+        return model.handle(report), model
+
+    def test_raw_past_the_end(self):
+        self.assertEqual(self.write(16, hid.ENC_RAW, 10, bytes(7))[0], EINVAL)
+        self.assertEqual(self.write(16, hid.ENC_RAW, 10, bytes(6))[0], 0)
+
+    def test_rle_past_the_end(self):
+        self.assertEqual(self.write(16, hid.ENC_RLE, 15, bytes([2, 1]))[0], EINVAL)
+        self.assertEqual(self.write(16, hid.ENC_RLE, 15, bytes([1, 1]))[0], 0)
+
+    def test_rejected_runs_are_not_applied(self):
+        status, model = self.write(16, hid.ENC_RLE, 0, bytes([8, 1, 8, 2, 1, 3]), flags=0)
+        self.assertEqual(status, EINVAL)
+        self.assertEqual(model.staging, bytes(16))
+
+    def test_odd_rle_payload(self):
+        self.assertEqual(self.write(16, hid.ENC_RLE, 0, bytes([1]))[0], EINVAL)
+
+    def test_unknown_encoding(self):
+        self.assertEqual(self.write(16, 7, 0, bytes(2))[0], ENOTSUP)
+
+
+if __name__ == '__main__':
+    unittest.main(verbosity=1)
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 The ZMK Contributors
+#
+# SPDX-License-Identifier: MIT
+
+"""Summarize the display stage durations of a Zephyr CTF trace.
+
+Build the dongle with CONFIG_ZMK_DONGLE_DISPLAY_TRACING=y and a CTF tracing
+backend, capture a trace and run:
+
+    scripts/trace_summary.py path/to/trace_dir
+
+The trace is decoded with the babeltrace2 command line tool. Already decoded
+text can be piped in with "-" as the path. Every stage reports its call count
+and its duration percentiles. With --stalls, each call longer than the given
+number of microseconds is also listed with its timestamp.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+# [12.345678901] (+0.000012345) zephyr named_event: { ... }, { name = "layer_update", arg0 = 0, arg1 = 0 }
+EVENT_RE = re.compile(
+    r'^\[(?P<ts>\d+\.\d+)\].*\bnamed_event:.*'
+    r'name = "(?P<name>[^"]*)", arg0 = (?P<arg0>\d+)'
+)
+
+STAGE_ENTER = 0
+STAGE_EXIT = 1
+
+
+def decode(path):
+    if path == '-':
+        return sys.stdin
+    try:
+        out = subprocess.run(['babeltrace2', '--clock-seconds', path], check=True,
+                             capture_output=True, text=True).stdout
+    except FileNotFoundError:
+        sys.exit('babeltrace2 not found, decode the trace yourself and pipe it in with "-"')
+    except subprocess.CalledProcessError as err:
+        sys.exit(f'babeltrace2 failed: {err.stderr.strip()}')
+    return out.splitlines()
+
+
+def collect(lines):
+    """Pair the entry and exit events of each stage into durations in microseconds."""
+    open_stages = defaultdict(list)
+    durations = defaultdict(list)
+    unmatched = 0
+
+    for line in lines:
+        m = EVENT_RE.match(line)
+        if m is None:
+            continue
+
+        name, ts, phase = m['name'], float(m['ts']), int(m['arg0'])
+        if phase == STAGE_ENTER:
+            open_stages[name].append(ts)
+        elif phase == STAGE_EXIT:
+            if not open_stages[name]:
+                unmatched += 1
+                continue
+            start = open_stages[name].pop()
+            durations[name].append((start, (ts - start) * 1e6))
+
+    unmatched += sum(len(starts) for starts in open_stages.values())
+    return durations, unmatched
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('trace', help='CTF trace directory, or - for decoded text on stdin')
+    parser.add_argument('--stalls', type=float, metavar='US',
+                        help='list every call that took longer than this many microseconds')
+    args = parser.parse_args()
+
+    durations, unmatched = collect(decode(args.trace))
+    if not durations:
+        sys.exit('no display stage events in the trace')
+
+    print(f'{"stage":<20} {"count":>7} {"min_us":>9} {"p50_us":>9} {"p99_us":>9} '
+          f'{"max_us":>9} {"total_ms":>9}')
+    for name in sorted(durations, key=lambda n: -sum(d for _, d in durations[n])):
+        values = sorted(d for _, d in durations[name])
+        print(f'{name:<20} {len(values):>7} {values[0]:>9.1f} {percentile(values, 50):>9.1f} '
+              f'{percentile(values, 99):>9.1f} {values[-1]:>9.1f} {sum(values) / 1000:>9.2f}')
+
+    if unmatched:
+        print(f'\n{unmatched} entry or exit events without a partner (trace cut or overflowed)')
+
+    if args.stalls is not None:
+        stalls = sorted((start, name, d) for name, calls in durations.items()
+                        for start, d in calls if d > args.stalls)
+        print(f'\n{len(stalls)} calls longer than {args.stalls:g} us')
+        for start, name, d in stalls:
+            print(f'{start:>16.9f} {name:<20} {d:>9.1f}')
+
+
+if __name__ == '__main__':
+    main()